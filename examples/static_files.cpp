@@ -1,6 +1,6 @@
 /*
  * 静态文件服务器示例
- * 演示如何提供静态文件服务
+ * 演示如何提供静态文件服务：文件作为文件区间正文，由 sendfile 发出，不读进内存
  */
 
 #include "tzzero/http/http_server.h"
@@ -8,8 +8,6 @@
 #include "tzzero/http/http_response.h"
 #include "tzzero/utils/logger.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <filesystem>
 
 using namespace tzzero::http;
@@ -40,19 +38,6 @@ std::string get_content_type(const std::string& path) {
     return "application/octet-stream";
 }
 
-// 读取文件内容
-bool read_file(const std::string& path, std::string& content) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file) {
-        return false;
-    }
-
-    std::ostringstream oss;
-    oss << file.rdbuf();
-    content = oss.str();
-    return true;
-}
-
 int main(int argc, char* argv[]) {
     Logger::instance().set_level(LogLevel::INFO);
 
@@ -89,14 +74,12 @@ int main(int argc, char* argv[]) {
             full_path += "/index.html";
         }
 
-        // 读取并返回文件
-        std::string content;
-        if (read_file(full_path, content)) {
+        // 打开文件作为正文，响应头发出后由 sendfile 从页缓存直接发送
+        if (resp.set_file_body(full_path)) {
             resp.set_status_code(HttpStatusCode::OK);
             resp.set_content_type(get_content_type(full_path));
-            resp.set_body(std::move(content));
 
-            LOG_INFO("Served: " << path << " (" << content.size() << " bytes)");
+            LOG_INFO("Served: " << path << " (" << resp.get_body_size() << " bytes)");
         } else {
             resp.set_status_code(HttpStatusCode::NOT_FOUND);
             resp.set_html_content_type();
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "tzzero/core/event_loop.h"
+#include "tzzero/core/poller.h"
+#include "tzzero/utils/thread_pool.h"
+#include <cassert>
+#include <coroutine>
+#include <cstdint>
+
+namespace tzzero::core {
+
+// 定时等待：挂起当前协程，delay 秒后在 loop 中恢复
+class SleepAwaiter {
+public:
+    SleepAwaiter(EventLoop* loop, double seconds) : loop_(loop), seconds_(seconds) {}
+
+    bool await_ready() const noexcept { return seconds_ <= 0; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        loop_->run_after(seconds_, [handle]() { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+
+private:
+    EventLoop* loop_;
+    double seconds_;
+};
+
+// 等待 fd 就绪：临时注册到 loop 的轮询器，触发后注销并恢复协程，返回就绪事件
+// fd 不能已由其他处理器（如 TcpConnection）注册；须在 loop 线程中 co_await
+class FdAwaiter {
+public:
+    FdAwaiter(EventLoop* loop, int fd, uint32_t events) : loop_(loop), fd_(fd), events_(events), ready_(0) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        assert(loop_->is_in_loop_thread());
+        loop_->get_poller()->add_fd(fd_, events_, [this, handle](int, uint32_t ready) {
+            ready_ = ready;
+            loop_->get_poller()->remove_fd(fd_);
+            handle.resume();
+        });
+    }
+    uint32_t await_resume() const noexcept { return ready_; }
+
+private:
+    EventLoop* loop_;
+    int fd_;
+    uint32_t events_;
+    uint32_t ready_;
+};
+
+// 跳转到另一个 EventLoop 继续执行，已在该循环线程中时不挂起
+class LoopHopAwaiter {
+public:
+    explicit LoopHopAwaiter(EventLoop* loop) : loop_(loop) {}
+
+    bool await_ready() const { return loop_->is_in_loop_thread(); }
+    void await_suspend(std::coroutine_handle<> handle) {
+        loop_->queue_in_loop([handle]() { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+
+private:
+    EventLoop* loop_;
+};
+
+// 跳转到线程池的工作线程继续执行，适合在协程中间做耗 CPU 的计算
+class PoolHopAwaiter {
+public:
+    explicit PoolHopAwaiter(utils::ThreadPool& pool) : pool_(pool) {}
+
+    bool await_ready() const { return pool_.in_worker_thread(); }
+    void await_suspend(std::coroutine_handle<> handle) {
+        pool_.post([handle]() { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+
+private:
+    utils::ThreadPool& pool_;
+};
+
+inline SleepAwaiter sleep_for(EventLoop* loop, double seconds) {
+    return SleepAwaiter(loop, seconds);
+}
+
+// 在当前线程的 EventLoop 上等待
+inline SleepAwaiter sleep_for(double seconds) {
+    assert(EventLoop::current() != nullptr);
+    return SleepAwaiter(EventLoop::current(), seconds);
+}
+
+inline FdAwaiter wait_readable(EventLoop* loop, int fd) {
+    return FdAwaiter(loop, fd, Poller::EVENT_READ);
+}
+
+inline FdAwaiter wait_writable(EventLoop* loop, int fd) {
+    return FdAwaiter(loop, fd, Poller::EVENT_WRITE);
+}
+
+inline LoopHopAwaiter resume_on(EventLoop* loop) {
+    return LoopHopAwaiter(loop);
+}
+
+inline PoolHopAwaiter resume_on(utils::ThreadPool& pool) {
+    return PoolHopAwaiter(pool);
+}
+
+}  // namespace tzzero::core
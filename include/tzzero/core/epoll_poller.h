@@ -3,7 +3,6 @@
 #include "poller.h"
 #include <sys/epoll.h>
 #include <vector>
-#include <unordered_map>
 
 namespace tzzero::core {
 
@@ -16,6 +15,7 @@ public:
     void add_fd(int fd, uint32_t events, std::function<void(int, uint32_t)> callback) override;
     void modify_fd(int fd, uint32_t events, std::function<void(int, uint32_t)> callback) override;
     void remove_fd(int fd) override;
+    void update_fd(int fd, uint32_t events) override;
 
 private:
     uint32_t events_to_epoll(uint32_t events) const;
@@ -23,7 +23,6 @@ private:
     
     int epoll_fd_;
     std::vector<epoll_event> events_;
-    std::unordered_map<int, std::function<void(int, uint32_t)>> fd_callbacks_;
     static constexpr int kInitEventListSize = 16;
 };
 
@@ -8,6 +8,11 @@
 #include <mutex>
 #include <condition_variable>
 #include <queue>
+#include "tzzero/utils/mpsc_queue.h"
+#include "tzzero/utils/latency_histogram.h"
+#include "tzzero/utils/cached_clock.h"
+#include "tzzero/core/loop_stats.h"
+#include "tzzero/core/frame_pool.h"
 
 namespace tzzero::core {
 
@@ -28,11 +33,15 @@ public:
     // 在当前线程启动事件循环
     void loop();
     
-    // 停止事件循环
+    // 停止事件循环；loop() 返回前会执行 quit 之前已投递的任务
     void quit();
     
     // 检查是否在循环线程中运行
     bool is_in_loop_thread() const;
+
+    // 当前线程的 EventLoop，没有时返回 nullptr
+    static EventLoop* current();
+    bool looping() const { return looping_.load(std::memory_order_relaxed); }
     
     // 在循环线程中执行回调
     void run_in_loop(EventCallback cb);
@@ -49,11 +58,66 @@ public:
     // 线程管理
     std::thread::id get_thread_id() const { return thread_id_; }
 
+    // 本轮缓存的时间，poll 返回后刷新一次，仅在循环线程中读取
+    const utils::CachedClock& clock() const { return clock_; }
+
+    // 本线程协程帧的复用池，仅在循环线程中访问
+    const FramePool& frame_pool() const { return frame_pool_; }
+
+    // 跨线程唤醒统计：实际写 eventfd 的次数 / 因循环未阻塞而省去的次数
+    uint64_t wakeups() const { return wakeups_.load(std::memory_order_relaxed); }
+    uint64_t wakeups_saved() const { return wakeups_saved_.load(std::memory_order_relaxed); }
+
+    // 忙轮询：有活动后以零超时 poll 自旋至多 budget_us 微秒再阻塞，0 表示关闭
+    // 空闲时自旋预算逐次减半，自旋期间收到事件则加倍，上限为 budget_us
+    // 须在循环开始前或循环线程中调用
+    void set_busy_poll(int budget_us);
+    int busy_poll() const { return static_cast<int>(busy_poll_max_ns_ / 1000); }
+
+    // 运行统计：各阶段耗时、每轮事件数、任务队列深度，可在任意线程读取
+    // 关闭后每轮少读三次时钟，繁忙度（utilization、recent_utilization）不再更新；
+    // 须在循环开始前或循环线程中调用，是否开启可在任意线程查询
+    const LoopStats& stats() const { return stats_; }
+    void set_stats_enabled(bool on) { stats_enabled_.store(on, std::memory_order_relaxed); }
+    bool stats_enabled() const { return stats_enabled_.load(std::memory_order_relaxed); }
+
+    // 连接计数，连接在本循环中建立/断开时调用
+    void connection_opened() { stats_.connection_opened(); }
+    void connection_closed() { stats_.connection_closed(); }
+
+    // 发送统计，连接写 socket 或复制数据进输出队列时调用
+    void output_syscall() { stats_.output_syscall(); }
+    void output_copied(size_t bytes) { stats_.output_copied(bytes); }
+    // 请求计数，协议层在循环线程中收到完整请求时调用
+    void request_handled() { stats_.request_handled(); }
+
+    // 当前待执行的跨线程任务数
+    size_t pending_tasks() const { return pending_count_.load(std::memory_order_relaxed); }
+
+    // 所在 NUMA 节点，由线程池在绑核且要求本地内存时设置，-1 表示未绑定
+    void set_numa_node(int node) { numa_node_ = node; }
+    int numa_node() const { return numa_node_; }
+
+    // 唤醒延迟：跨线程任务从入队到循环本轮醒来处理的耗时（纳秒）
+    const utils::LatencyHistogram& wakeup_latency() const { return wakeup_latency_; }
+
 private:
+    // 节点从入队线程的帧池分配，归还给执行线程的池；本线程入队的任务不走 malloc
+    struct PendingTask : utils::MpscNode {
+        PendingTask(EventCallback cb, int64_t ns) : callback(std::move(cb)), enqueue_ns(ns) {}
+        static void* operator new(size_t size) { return FramePool::allocate(size); }
+        static void operator delete(void* ptr, size_t size) noexcept { FramePool::deallocate(ptr, size); }
+        EventCallback callback;
+        int64_t enqueue_ns;
+    };
+
     void wake_up();
     void handle_wake_up();
-    void do_pending_functors();
+    bool do_pending_functors();
+    bool busy_poll_continue(bool had_work);
 
+    utils::CachedClock clock_;
+    FramePool frame_pool_;      // 晚于 poller_/timer_queue_ 析构，它们析构时释放的帧仍可归还
     std::unique_ptr<Poller> poller_;
     std::unique_ptr<TimerQueue> timer_queue_;
     
@@ -63,9 +127,30 @@ private:
     
     // 用于跨线程调用
     int wakeup_fd_;
-    std::mutex mutex_;
-    std::vector<EventCallback> pending_functors_;
+    utils::MpscQueue<PendingTask> pending_tasks_;
+    std::atomic<size_t> pending_count_{0};
     bool calling_pending_functors_{false};
+
+    // 仅当循环阻塞在 poll() 中时才写 eventfd
+    std::atomic<bool> polling_{false};
+    std::atomic<bool> wakeup_pending_{false};
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<uint64_t> wakeups_saved_{0};
+
+    // 忙轮询状态，仅在循环线程访问
+    int64_t busy_poll_max_ns_{0};
+    int64_t busy_poll_min_ns_{0};
+    int64_t spin_budget_ns_{0};
+    int64_t spin_deadline_ns_{0};
+    bool spinning_{false};
+    bool spin_found_work_{false};
+
+    int numa_node_{-1};
+
+    std::atomic<bool> stats_enabled_{true};
+    LoopStats stats_;
+
+    utils::LatencyHistogram wakeup_latency_;
 };
 
 }  // namespace tzzero::core
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace tzzero::core {
+
+// 单个 fd 的事件处理器
+//
+// 由 FdHandlerTable 按 fd 下标存放，地址在轮询器生命周期内不变，
+// 轮询器可以把它的指针直接放进内核事件（如 epoll_event.data.ptr），
+// 分发时不再查表、也不拷贝 std::function
+class FdHandler {
+public:
+    using EventCallback = std::function<void(int fd, uint32_t events)>;
+
+    int fd() const { return fd_; }
+    bool registered() const { return registered_; }
+
+    // 每次注销递增；PollEvent 记录取出时的值，用于丢弃同一轮中已失效的事件
+    uint32_t epoch() const { return epoch_; }
+
+    void set(EventCallback callback) {
+        registered_ = true;
+        if (dispatching_) {
+            // 回调正在执行，不能销毁它，等本次分发结束后再替换
+            deferred_ = std::move(callback);
+            has_deferred_ = true;
+        } else {
+            callback_ = std::move(callback);
+        }
+    }
+
+    void reset() {
+        registered_ = false;
+        ++epoch_;
+        if (dispatching_) {
+            deferred_ = nullptr;
+            has_deferred_ = true;
+        } else {
+            callback_ = nullptr;
+        }
+    }
+
+    // 事件已失效（epoch 不符或回调已清除）时不调用，返回 false
+    bool dispatch(int fd, uint32_t events, uint32_t epoch) {
+        if (epoch != epoch_ || !callback_) {
+            return false;
+        }
+
+        dispatching_ = true;
+        callback_(fd, events);
+        dispatching_ = false;
+
+        if (has_deferred_) {
+            callback_ = std::move(deferred_);
+            deferred_ = nullptr;
+            has_deferred_ = false;
+        }
+        return true;
+    }
+
+private:
+    friend class FdHandlerTable;
+
+    EventCallback callback_;
+    EventCallback deferred_;
+    int fd_{-1};
+    uint32_t epoch_{0};
+    bool registered_{false};
+    bool dispatching_{false};
+    bool has_deferred_{false};
+};
+
+// 按 fd 下标索引的处理器表
+// 分块分配，扩容时已有处理器不移动；块只在表析构时释放
+class FdHandlerTable {
+public:
+    FdHandlerTable() = default;
+
+    // 不可拷贝
+    FdHandlerTable(const FdHandlerTable&) = delete;
+    FdHandlerTable& operator=(const FdHandlerTable&) = delete;
+
+    // 未分配过时返回 nullptr
+    FdHandler* find(int fd) const {
+        size_t chunk = static_cast<size_t>(fd) / kChunkSize;
+        if (fd < 0 || chunk >= chunks_.size() || !chunks_[chunk]) {
+            return nullptr;
+        }
+        return &chunks_[chunk][static_cast<size_t>(fd) % kChunkSize];
+    }
+
+    FdHandler& get(int fd) {
+        size_t chunk = static_cast<size_t>(fd) / kChunkSize;
+        if (chunk >= chunks_.size()) {
+            chunks_.resize(chunk + 1);
+        }
+        if (!chunks_[chunk]) {
+            chunks_[chunk] = std::make_unique<FdHandler[]>(kChunkSize);
+            int base = static_cast<int>(chunk * kChunkSize);
+            for (size_t i = 0; i < kChunkSize; ++i) {
+                chunks_[chunk][i].fd_ = base + static_cast<int>(i);
+            }
+        }
+        return chunks_[chunk][static_cast<size_t>(fd) % kChunkSize];
+    }
+
+private:
+    static constexpr size_t kChunkSize = 1024;
+
+    std::vector<std::unique_ptr<FdHandler[]>> chunks_;
+};
+
+}  // namespace tzzero::core
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace tzzero::core {
+
+// 协程帧池
+//
+// 每个 EventLoop 一份，构造时绑定为所在线程的当前池。协程帧按 64 字节对齐的
+// 尺寸类分配，释放时挂回当前线程池的空闲链表，下一个同尺寸协程直接复用，
+// 挂起中的请求不再走 malloc。连接对象、缓冲区和循环任务节点同样经
+// PoolAllocator 从这里分配，建连断连不再走 malloc。帧可以在线程间迁移（跨循环跳转后在另一线程结束），
+// 归还给结束线程的池；没有池的线程（如工作线程）直接使用全局分配器。
+// 分配尺寸只取决于帧大小，与线程无关，因此任意线程释放都安全。
+// 块都按缓存行对齐。
+class FramePool {
+public:
+    FramePool();
+    ~FramePool();
+
+    // 不可拷贝
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // 绑定为当前线程的池，EventLoop 构造/析构时调用
+    void attach();
+    void detach();
+
+    // 协程 promise 的 operator new/delete 调用
+    static void* allocate(size_t size);
+    static void deallocate(void* ptr, size_t size) noexcept;
+
+    // 统计，只在所属线程读取
+    uint64_t allocations() const { return allocations_; }
+    uint64_t reused() const { return reused_; }
+    size_t cached() const;
+
+    static constexpr size_t kGranularity = 64;
+    static constexpr size_t kMaxPooledSize = 4096;
+    static constexpr size_t kMaxCachedPerClass = 1024;
+
+private:
+    static constexpr size_t kClasses = kMaxPooledSize / kGranularity;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static size_t class_of(size_t size) { return (size + kGranularity - 1) / kGranularity - 1; }
+    static size_t class_size(size_t index) { return (index + 1) * kGranularity; }
+
+    void* pop(size_t size);
+    bool push(void* ptr, size_t size) noexcept;
+
+    FreeBlock* free_lists_[kClasses];
+    uint32_t counts_[kClasses];
+    uint64_t allocations_;
+    uint64_t reused_;
+};
+
+// 从当前线程的 FramePool 分配的标准分配器，无状态，任意线程释放都安全
+// 块按 kGranularity（缓存行）对齐
+template<typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        static_assert(alignof(T) <= FramePool::kGranularity, "over-aligned type");
+        return static_cast<T*>(FramePool::allocate(n * sizeof(T)));
+    }
+    void deallocate(T* ptr, size_t n) noexcept {
+        FramePool::deallocate(ptr, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+};
+
+}  // namespace tzzero::core
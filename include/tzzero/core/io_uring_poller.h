@@ -0,0 +1,82 @@
+#pragma once
+
+#include "poller.h"
+#include <linux/io_uring.h>
+#include <vector>
+
+namespace tzzero::core {
+
+// 基于 io_uring 的轮询器，直接使用系统调用，不依赖 liburing
+//
+// - 边沿触发的 fd 使用 multishot poll，注册一次持续产生完成事件
+// - 水平触发的 fd 使用 oneshot poll，每次完成后在下一轮重新提交，
+//   保持与 EpollPoller 相同的语义（内核不支持 multishot + level）
+// - 监听 fd 可通过 add_accept_fd 使用 multishot accept
+// - add/modify/remove 只写入 SQ，在 poll() 中随等待一起用一次
+//   io_uring_enter 提交
+class IoUringPoller : public Poller {
+public:
+    explicit IoUringPoller(EventLoop* loop);
+    ~IoUringPoller() override;
+
+    int poll(int timeout_ms, std::vector<PollEvent>& active_events) override;
+    void add_fd(int fd, uint32_t events, std::function<void(int, uint32_t)> callback) override;
+    void modify_fd(int fd, uint32_t events, std::function<void(int, uint32_t)> callback) override;
+    void remove_fd(int fd) override;
+    void update_fd(int fd, uint32_t events) override;
+    bool add_accept_fd(int listen_fd, AcceptCallback callback) override;
+
+private:
+    // 回调存放在基类的处理器表中，这里只记录提交状态
+    struct FdEntry {
+        uint32_t events{0};
+        uint32_t generation{0};
+        bool accept{false};
+        bool registered{false};
+    };
+
+    FdEntry* find_entry(int fd);
+    FdEntry& register_entry(int fd);
+
+    io_uring_sqe* get_sqe();
+    int submit(unsigned wait_nr, const struct __kernel_timespec* ts);
+    void arm(int fd, const FdEntry& entry);
+    void cancel(int fd, const FdEntry& entry);
+    void rearm_pending();
+    void reap(std::vector<PollEvent>& active_events);
+
+    uint32_t next_generation();
+    static uint64_t make_user_data(int fd, const FdEntry& entry);
+    uint32_t events_to_poll(uint32_t events) const;
+    uint32_t poll_to_events(uint32_t poll_events) const;
+
+    int ring_fd_;
+
+    // 映射的环形队列
+    void* sq_ring_ptr_;
+    size_t sq_ring_size_;
+    void* cq_ring_ptr_;
+    size_t cq_ring_size_;
+    io_uring_sqe* sqes_;
+    size_t sqes_size_;
+
+    unsigned* sq_head_;
+    unsigned* sq_tail_;
+    unsigned* sq_array_;
+    unsigned sq_mask_;
+    unsigned sq_entries_;
+
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    io_uring_cqe* cqes_;
+    unsigned cq_mask_;
+
+    std::vector<FdEntry> fd_entries_;   // 按 fd 下标索引
+    std::vector<std::pair<int, uint32_t>> rearm_list_;
+    uint32_t next_generation_;
+
+    static constexpr unsigned kSqEntries = 1024;
+    static constexpr unsigned kCqEntries = 8192;
+};
+
+}  // namespace tzzero::core
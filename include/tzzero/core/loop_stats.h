@@ -0,0 +1,141 @@
+#pragma once
+
+#include "tzzero/utils/latency_histogram.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace tzzero::core {
+
+// EventLoop 自身的运行统计
+//
+// 每轮记录 poll 阻塞时间、定时器 / I/O 回调 / 待执行任务各自的耗时、
+// 本轮事件数和任务队列深度。只由循环线程写入，其他线程可随时无锁读取，
+// 读到的是近似快照。
+class LoopStats {
+public:
+    LoopStats() = default;
+
+    // 不可拷贝
+    LoopStats(const LoopStats&) = delete;
+    LoopStats& operator=(const LoopStats&) = delete;
+
+    // 循环线程每轮调用一次
+    void record_iteration(int64_t poll_ns, int64_t timer_ns, int64_t io_ns,
+                          int64_t functor_ns, size_t events, size_t queue_depth) {
+        poll_time_.record(clamp(poll_ns));
+        timer_time_.record(clamp(timer_ns));
+        io_time_.record(clamp(io_ns));
+        functor_time_.record(clamp(functor_ns));
+        events_per_iteration_.record(events);
+        queue_depth_.record(queue_depth);
+
+        add(iterations_, 1);
+        add(poll_ns_total_, clamp(poll_ns));
+        add(timer_ns_total_, clamp(timer_ns));
+        add(io_ns_total_, clamp(io_ns));
+        add(functor_ns_total_, clamp(functor_ns));
+        add(events_total_, events);
+        if (queue_depth > max_queue_depth_.load(std::memory_order_relaxed)) {
+            max_queue_depth_.store(queue_depth, std::memory_order_relaxed);
+        }
+
+        uint64_t busy = clamp(timer_ns) + clamp(io_ns) + clamp(functor_ns);
+        window_busy_ns_ += busy;
+        window_total_ns_ += busy + clamp(poll_ns);
+        if (window_total_ns_ >= kWindowNs) {
+            update_recent_utilization();
+        }
+    }
+
+    // 本循环上的活跃连接数和累计建立数，TcpConnection 在循环线程中维护
+    void connection_opened() {
+        add(connections_total_, 1);
+        connections_.store(connections_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    void connection_closed() {
+        connections_.store(connections_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+    int64_t connections() const { return connections_.load(std::memory_order_relaxed); }
+    uint64_t connections_total() const { return connections_total_.load(std::memory_order_relaxed); }
+
+    // 发送路径，TcpConnection 在循环线程中维护：write/writev 调用次数，
+    // 以及复制进输出队列的字节数（接管的字符串、共享和静态数据不计）
+    void output_syscall() { add(output_syscalls_, 1); }
+    void output_copied(size_t bytes) { add(output_bytes_copied_, bytes); }
+    uint64_t output_syscalls() const { return output_syscalls_.load(std::memory_order_relaxed); }
+    uint64_t output_bytes_copied() const { return output_bytes_copied_.load(std::memory_order_relaxed); }
+
+    // 协议层在循环线程中处理的请求数，与发送调用数相比看出响应合并的程度
+    void request_handled() { add(requests_, 1); }
+    uint64_t requests() const { return requests_.load(std::memory_order_relaxed); }
+    double writes_per_request() const {
+        uint64_t n = requests();
+        return n > 0 ? static_cast<double>(output_syscalls()) / static_cast<double>(n) : 0.0;
+    }
+
+    uint64_t iterations() const { return iterations_.load(std::memory_order_relaxed); }
+    uint64_t events() const { return events_total_.load(std::memory_order_relaxed); }
+    uint64_t poll_ns() const { return poll_ns_total_.load(std::memory_order_relaxed); }
+    uint64_t timer_ns() const { return timer_ns_total_.load(std::memory_order_relaxed); }
+    uint64_t io_ns() const { return io_ns_total_.load(std::memory_order_relaxed); }
+    uint64_t functor_ns() const { return functor_ns_total_.load(std::memory_order_relaxed); }
+    size_t max_queue_depth() const { return max_queue_depth_.load(std::memory_order_relaxed); }
+
+    // 每轮的分布
+    const utils::LatencyHistogram& poll_time() const { return poll_time_; }
+    const utils::LatencyHistogram& timer_time() const { return timer_time_; }
+    const utils::LatencyHistogram& io_time() const { return io_time_; }
+    const utils::LatencyHistogram& functor_time() const { return functor_time_; }
+    const utils::LatencyHistogram& events_per_iteration() const { return events_per_iteration_; }
+    const utils::LatencyHistogram& queue_depth() const { return queue_depth_; }
+
+    // 非 poll 时间占比，接近 1 说明循环已饱和
+    double utilization() const {
+        double busy = static_cast<double>(timer_ns() + io_ns() + functor_ns());
+        double total = busy + static_cast<double>(poll_ns());
+        return total > 0 ? busy / total : 0.0;
+    }
+
+    // 最近一段时间的非 poll 时间占比（约 100ms 窗口的指数平均），用于负载均衡
+    double recent_utilization() const { return recent_utilization_.load(std::memory_order_relaxed); }
+
+    // 单行摘要，便于日志输出
+    std::string summary() const;
+
+private:
+    static constexpr uint64_t kWindowNs = 100 * 1000 * 1000;
+
+    void update_recent_utilization();
+
+    static uint64_t clamp(int64_t ns) { return ns > 0 ? static_cast<uint64_t>(ns) : 0; }
+
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> iterations_{0};
+    std::atomic<uint64_t> events_total_{0};
+    std::atomic<uint64_t> poll_ns_total_{0};
+    std::atomic<uint64_t> timer_ns_total_{0};
+    std::atomic<uint64_t> io_ns_total_{0};
+    std::atomic<uint64_t> functor_ns_total_{0};
+    std::atomic<size_t> max_queue_depth_{0};
+    std::atomic<int64_t> connections_{0};
+    std::atomic<uint64_t> connections_total_{0};
+    std::atomic<uint64_t> output_syscalls_{0};
+    std::atomic<uint64_t> output_bytes_copied_{0};
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<double> recent_utilization_{0.0};
+    uint64_t window_busy_ns_ = 0;     // 仅循环线程访问
+    uint64_t window_total_ns_ = 0;
+
+    utils::LatencyHistogram poll_time_;
+    utils::LatencyHistogram timer_time_;
+    utils::LatencyHistogram io_time_;
+    utils::LatencyHistogram functor_time_;
+    utils::LatencyHistogram events_per_iteration_;
+    utils::LatencyHistogram queue_depth_;
+};
+
+}  // namespace tzzero::core
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "fd_handler.h"
+#include <unistd.h>
 #include <vector>
 #include <memory>
 #include <functional>
@@ -8,15 +10,27 @@ namespace tzzero::core {
 
 class EventLoop;
 
+// 就绪事件只携带处理器指针，分发时不拷贝回调
 struct PollEvent {
     int fd;
     uint32_t events;
-    std::function<void(int, uint32_t)> callback;
+    FdHandler* handler;
+    uint32_t epoch;     // 取出事件时处理器的 epoch
+    bool accepted = false;  // fd 是轮询器已 accept 的新连接
+
+    void dispatch() const {
+        if (!handler->dispatch(fd, events, epoch) && accepted && fd >= 0) {
+            // 监听处理器在同一轮中已注销，新连接没有人接收，不能泄漏
+            ::close(fd);
+        }
+    }
 };
 
 class Poller {
 public:
     using EventCallback = std::function<void(int fd, uint32_t events)>;
+    // conn_fd < 0 时为 -errno
+    using AcceptCallback = std::function<void(int conn_fd)>;
     
     explicit Poller(EventLoop* loop);
     virtual ~Poller() = default;
@@ -32,6 +46,17 @@ public:
     virtual void add_fd(int fd, uint32_t events, std::function<void(int, uint32_t)> callback) = 0;
     virtual void modify_fd(int fd, uint32_t events, std::function<void(int, uint32_t)> callback) = 0;
     virtual void remove_fd(int fd) = 0;
+
+    // 只修改关注的事件，保留已注册的回调
+    virtual void update_fd(int fd, uint32_t events) = 0;
+
+    // 由轮询器直接完成 accept（如 io_uring multishot accept）
+    // 返回 false 表示不支持，调用方应退回到可读事件 + accept4
+    virtual bool add_accept_fd(int listen_fd, AcceptCallback callback) {
+        (void)listen_fd;
+        (void)callback;
+        return false;
+    }
     
     // 事件标志
     static constexpr uint32_t EVENT_READ = 0x001;
@@ -42,6 +67,7 @@ public:
 
 protected:
     EventLoop* owner_loop_;
+    FdHandlerTable handlers_;
 };
 
 // 工厂函数，用于创建适当的轮询器
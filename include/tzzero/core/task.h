@@ -0,0 +1,139 @@
+#pragma once
+
+#include "tzzero/core/frame_pool.h"
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace tzzero::core {
+
+namespace detail {
+
+// 所有协程 promise 的公共部分：帧从 FramePool 分配，结束时对称转移回等待者
+struct PromiseBase {
+    static void* operator new(size_t size) { return FramePool::allocate(size); }
+    static void operator delete(void* ptr, size_t size) noexcept { FramePool::deallocate(ptr, size); }
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            std::coroutine_handle<> continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+};
+
+template<typename T>
+struct Promise : PromiseBase {
+    template<typename U>
+    void return_value(U&& value) { result.emplace(std::forward<U>(value)); }
+
+    T take() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*result);
+    }
+
+    std::optional<T> result;
+};
+
+template<>
+struct Promise<void> : PromiseBase {
+    void return_void() const noexcept {}
+
+    void take() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+}  // namespace detail
+
+// 惰性启动的协程任务
+//
+// 创建后不执行，被 co_await 时才开始，完成后直接恢复等待者（对称转移，
+// 不经过事件循环）。异常在 co_await 处重新抛出。只能移动，销毁时释放协程帧。
+template<typename T = void>
+class [[nodiscard]] Task {
+public:
+    struct promise_type : detail::Promise<T> {
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+    };
+
+    Task() = default;
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    // 不可拷贝
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool valid() const { return static_cast<bool>(handle_); }
+
+    // 空任务（默认构造或已被移走）没有结果可取，co_await 时抛出异常
+    bool await_ready() const {
+        if (!handle_) {
+            throw std::logic_error("co_await on an empty Task");
+        }
+        return handle_.done();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    T await_resume() { return handle_.promise().take(); }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// 立即启动、结束时自行销毁的协程，用于从普通回调中发起协程
+// 协程体内须自行处理异常，逃逸的异常会终止进程
+struct Detached {
+    struct promise_type : detail::PromiseBase {
+        Detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+// 在当前线程启动任务，不等待结果；任务抛出的异常记录日志后丢弃
+Detached spawn(Task<void> task);
+
+}  // namespace tzzero::core
@@ -3,8 +3,9 @@
 #include <functional>
 #include <memory>
 #include <vector>
-#include <set>
+#include <unordered_map>
 #include <atomic>
+#include <cstdint>
 
 namespace tzzero::core {
 
@@ -12,31 +13,13 @@ class EventLoop;
 
 using TimerCallback = std::function<void()>;
 
-class Timer {
-public:
-    Timer(double when, double interval, TimerCallback cb);
-    
-    void run() const { callback_(); }
-    bool repeat() const { return repeat_; }
-    double when() const { return expiration_; }
-    uint64_t sequence() const { return sequence_; }
-    
-    void restart(double now);
-    
-    static uint64_t num_created() { return s_num_created_.load(); }
-
-private:
-    const TimerCallback callback_;
-    double expiration_;
-    const double interval_;
-    const bool repeat_;
-    const uint64_t sequence_;
-    
-    static std::atomic<uint64_t> s_num_created_;
-};
-
-using TimerPtr = std::unique_ptr<Timer>;
-
+// 分层时间轮定时器队列
+//
+// - 时间以整数纳秒表示，按 1ms 一个 tick 组织成 4 层 x 256 槽的时间轮，
+//   覆盖约 49 天，更远的定时器在顶层反复级联
+// - 每个槽是带哨兵的侵入式双向链表，添加/取消/到期均为 O(1)
+// - 定时器节点从分块 slab 中分配，块地址稳定，回调执行期间可安全增删
+// - add_timer/cancel_timer 线程安全：非循环线程调用时转交到循环线程执行
 class TimerQueue {
 public:
     explicit TimerQueue(EventLoop* loop);
@@ -47,38 +30,93 @@ public:
     TimerQueue& operator=(const TimerQueue&) = delete;
 
     // 添加定时器，返回定时器ID
-    uint64_t add_timer(double when, double interval, TimerCallback cb);
-    
+    uint64_t add_timer(double delay, double interval, TimerCallback cb);
+
     // 取消定时器
     void cancel_timer(uint64_t timer_id);
-    
+
     // 获取下一次超时时间（毫秒），-1表示无超时
+    // 基于上一次 process_expired_timers 记录的时间，不读取时钟
     int get_next_timeout() const;
-    
-    // 处理已过期的定时器
-    void process_expired_timers();
+
+    // 处理已过期的定时器，now_ns 为循环本轮缓存的单调时间
+    void process_expired_timers(int64_t now_ns);
+
+    // 活跃定时器数量
+    size_t size() const { return size_; }
+
+    static constexpr int64_t kTickNs = 1000000;   // 1ms
 
 private:
-    using Entry = std::pair<double, Timer*>;
-    using TimerList = std::set<Entry>;
-    using ActiveTimer = std::pair<Timer*, uint64_t>;
-    using ActiveTimerSet = std::set<ActiveTimer>;
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 8;
+    static constexpr uint32_t kSlots = 1u << kSlotBits;
+    static constexpr uint32_t kSlotMask = kSlots - 1;
+    static constexpr uint32_t kChunkSize = 1024;
+    static constexpr uint32_t kNil = UINT32_MAX;
+    static constexpr uint16_t kNoSlot = UINT16_MAX;
 
-    void add_timer_in_loop(TimerPtr timer);
+    enum class NodeState : uint8_t {
+        FREE,
+        ACTIVE,     // 在时间轮中
+        RUNNING,    // 回调执行中
+        CANCELED    // 回调执行中被取消
+    };
+
+    struct TimerNode {
+        TimerCallback callback;
+        int64_t expiration{0};      // 纳秒
+        int64_t interval{0};        // 纳秒，0 表示一次性
+        uint64_t remote_id{0};      // 跨线程添加时返回给调用方的ID
+        uint32_t prev{kNil};
+        uint32_t next{kNil};
+        uint32_t generation{0};
+        uint16_t slot{kNoSlot};
+        NodeState state{NodeState::FREE};
+    };
+
+    uint64_t add_timer_in_loop(int64_t expiration, int64_t interval, TimerCallback cb);
     void cancel_in_loop(uint64_t timer_id);
-    void handle_timer_fd();
-    
-    std::vector<Entry> get_expired(double now);
-    void reset(const std::vector<Entry>& expired, double now);
-    
-    bool insert(Timer* timer);
+
+    TimerNode& node(uint32_t index) {
+        return chunks_[index / kChunkSize][index % kChunkSize];
+    }
+    const TimerNode& node(uint32_t index) const {
+        return chunks_[index / kChunkSize][index % kChunkSize];
+    }
+
+    uint32_t allocate_node();
+    void free_node(uint32_t index);
+
+    // 链表操作，slot 为 level * kSlots + 槽号
+    uint32_t sentinel(uint16_t slot) const { return slot; }
+    void link(uint32_t index, uint16_t slot);
+    void unlink(uint32_t index);
+    void place(uint32_t index);
+
+    void cascade(uint64_t tick);
+    void expire_slot(uint16_t slot);
+    void run_expired();
+
+    // 位图查找：从 from 开始（循环）的第一个非空槽偏移，没有返回 kSlots
+    uint32_t find_next_slot(int level, uint32_t from, bool wrap) const;
 
     EventLoop* loop_;
-    const int timer_fd_;
-    TimerList timers_;
-    ActiveTimerSet active_timers_;
-    std::atomic<bool> calling_expired_timers_;
-    ActiveTimerSet canceling_timers_;
+
+    std::vector<std::unique_ptr<TimerNode[]>> chunks_;
+    uint32_t free_head_;
+    uint32_t capacity_;
+    size_t size_;
+
+    uint64_t occupied_[kLevels][kSlots / 64];
+    uint64_t current_tick_;         // 下一个待处理的 tick
+    int64_t now_ns_;                // 最近一次处理时的时间
+    uint32_t expired_;              // 到期待执行链表的哨兵
+    uint32_t next_generation_;
+
+    // 跨线程添加的定时器：对外ID -> 内部ID，仅在循环线程访问
+    std::unordered_map<uint64_t, uint64_t> remote_ids_;
+    std::atomic<uint64_t> next_remote_id_;
 };
 
 }  // namespace tzzero::core
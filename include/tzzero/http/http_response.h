@@ -1,8 +1,10 @@
 #pragma once
 
+#include "tzzero/net/output_queue.h"
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <sys/types.h>
 
 namespace tzzero::http {
 
@@ -75,7 +77,17 @@ public:
     void set_body(std::string&& body);
     void append_body(const std::string& data);
     const std::string& get_body() const { return body_; }
-    void clear_body() { body_.clear(); }
+    void clear_body() { body_.clear(); file_.reset(); }
+
+    // File body: the region [offset, offset + length) of fd is sent with
+    // sendfile after the head and is never read into memory. The response
+    // takes ownership of fd, which is closed once the body is sent or dropped.
+    // Setting a string body replaces it.
+    void set_file_body(int fd, off_t offset, size_t length);
+    // Whole regular file at path; false if it cannot be opened
+    bool set_file_body(const std::string& path);
+    bool has_file_body() const { return file_ != nullptr; }
+    size_t get_body_size() const { return file_ ? file_length_ : body_.size(); }
 
     // Content type helpers
     void set_content_type(const std::string& content_type);
@@ -90,8 +102,15 @@ public:
     void reset();
 
     // Serialization
+    // A file body is read with pread; throws std::runtime_error (leaving the
+    // buffer unchanged) if the file cannot supply the declared length
     std::string to_buffer() const;
     void append_to_buffer(std::string& buffer) const;
+    // Status line and headers only, terminated by the blank line
+    void append_head_to_buffer(std::string& buffer) const;
+    // Queue the head and the body as separate slices; the body is moved, not
+    // copied, and is left empty. A file body is queued as a file region
+    void move_to_queue(net::OutputQueue& queue);
 
     // HTTP/2 specific
     void set_stream_id(uint32_t stream_id) { stream_id_ = stream_id; }
@@ -104,6 +123,9 @@ private:
     bool close_connection_{false};
     std::unordered_map<std::string, std::string> headers_;
     std::string body_;
+    std::shared_ptr<const net::OpenFile> file_;  // File body, shared by copies
+    off_t file_offset_{0};
+    size_t file_length_{0};
     uint32_t stream_id_{0}; // For HTTP/2
 };
 
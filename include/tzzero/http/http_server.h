@@ -3,6 +3,8 @@
 #include "tzzero/net/tcp_server.h"
 #include "tzzero/http/http_request.h"
 #include "tzzero/http/http_response.h"
+#include "tzzero/utils/thread_pool.h"
+#include "tzzero/core/task.h"
 #include <functional>
 #include <memory>
 
@@ -15,6 +17,8 @@ namespace tzzero::http {
 class HttpServer {
 public:
     using HttpCallback = std::function<void(const HttpRequest&, HttpResponse&)>;
+    using OffloadPredicate = std::function<bool(const HttpRequest&)>;
+    using AsyncHttpCallback = std::function<core::Task<HttpResponse>(const HttpRequest&)>;
 
     HttpServer(core::EventLoop* loop, const std::string& listen_addr, uint16_t port,
                const std::string& name = "TZZeroHTTP");
@@ -35,12 +39,50 @@ public:
      */
     void set_http_callback(const HttpCallback& cb) { http_callback_ = cb; }
 
+    /**
+     * 设置协程处理器，设置后优先于同步回调
+     * 处理器在连接所属I/O线程中启动，可 co_await 定时器、fd 就绪或跳转到其他
+     * 循环/线程池；请求对象在协程结束前有效。未设置的默认头部在完成后补上，
+     * 响应按请求顺序发出。
+     */
+    void set_async_http_callback(const AsyncHttpCallback& cb) { async_http_callback_ = cb; }
+
     /**
      * 服务器配置
      */
-    void set_thread_num(int num_threads);
+    void set_thread_num(int num_threads, const net::ThreadAffinity& affinity = net::ThreadAffinity{});
     void enable_keep_alive(bool enable) { keep_alive_enabled_ = enable; }
+    // 空闲超过该时间的连接会被关闭，0 表示不限制（必须在start之前调用）
     void set_keep_alive_timeout(int seconds) { keep_alive_timeout_ = seconds; }
+    // 一个连接最多同时等待发出的响应数（含转交工作线程和协程中未完成的），
+    // 达到上限时暂停解析该连接的请求，响应发出后在事件循环下一轮继续，
+    // 避免一个连接占住I/O线程或灌满工作线程池；0 表示不限制（必须在start之前调用）
+    void set_max_pipelined_requests(size_t max) { max_pipelined_requests_ = max; }
+    void enable_edge_triggered(bool enable) { server_->set_edge_triggered(enable); }
+    void set_busy_poll(int usec) { server_->set_busy_poll(usec); }
+    // 不小于该大小的响应正文用 MSG_ZEROCOPY 发送，0 关闭（必须在start之前调用）
+    void set_zerocopy_threshold(size_t bytes) { server_->set_zerocopy_threshold(bytes); }
+    // 新连接分配到I/O线程的策略（必须在start之前调用）
+    void set_load_balance(net::LoadBalance strategy) { server_->set_load_balance(strategy); }
+    // 每个I/O线程各自 SO_REUSEPORT 监听并本地 accept（必须在start之前调用）
+    void set_accept_per_loop(bool on, bool cpu_steering = false) {
+        server_->set_accept_per_loop(on, cpu_steering);
+    }
+
+    /**
+     * 因 Keep-Alive 超时被关闭的连接数
+     */
+    uint64_t reaped_connections() const { return server_->reaped_connections(); }
+
+    /**
+     * 处理器转交到工作线程池执行（必须在start之前调用）
+     * 回调和响应序列化在工作线程中完成，结果投递回连接所属的I/O线程，
+     * 同一连接上的响应按请求顺序发出。池中队列已满时退回I/O线程直接执行。
+     * predicate 为空时所有请求都转交，否则只转交返回 true 的请求（如按路径区分）
+     */
+    void set_worker_threads(size_t num_threads);
+    void set_worker_pool(std::shared_ptr<utils::ThreadPool> pool) { worker_pool_ = std::move(pool); }
+    void set_offload_predicate(const OffloadPredicate& predicate) { offload_predicate_ = predicate; }
 
     /**
      * HTTP/2配置（预留接口）
@@ -55,21 +97,43 @@ public:
 #endif
 
 private:
+    struct ConnectionState;
+    using ConnectionStatePtr = std::shared_ptr<ConnectionState>;
+
     // 连接建立/关闭回调
     void on_connection(const net::TcpConnectionPtr& conn);
 
     // 消息到达回调
     void on_message(const net::TcpConnectionPtr& conn, utils::Buffer& buffer);
 
+    // 继续处理上次因达到上限留在输入缓冲中的请求
+    void resume_pipeline(const net::TcpConnectionPtr& conn);
+
     // 完整HTTP请求到达回调
-    void on_request(const net::TcpConnectionPtr& conn, const HttpRequest& req);
+    void on_request(const net::TcpConnectionPtr& conn, const ConnectionStatePtr& state, HttpRequest&& req);
+
+    // 设置默认头部、调用用户回调并序列化为头部和正文两段，可在工作线程中执行
+    net::OutputQueue handle_request(const HttpRequest& req, bool& close_connection) const;
+
+    // 默认头部
+    void set_default_headers(const HttpRequest& req, HttpResponse& response) const;
+
+    // 运行协程处理器，完成后回到连接所属I/O线程按序发出响应
+    core::Detached run_async_handler(net::TcpConnectionPtr conn, ConnectionStatePtr state, HttpRequest req);
+
+    // 按请求顺序把队首连续已完成的响应一次交给连接，在I/O线程中调用
+    void flush_responses(const net::TcpConnectionPtr& conn, ConnectionState& state);
 
     core::EventLoop* loop_;                      // 事件循环
     std::unique_ptr<net::TcpServer> server_;     // TCP服务器
     HttpCallback http_callback_;                 // HTTP请求处理回调
+    AsyncHttpCallback async_http_callback_;      // 协程处理器
+    std::shared_ptr<utils::ThreadPool> worker_pool_;  // 处理器工作线程池，为空时在I/O线程执行
+    OffloadPredicate offload_predicate_;         // 哪些请求转交工作线程池
 
     bool keep_alive_enabled_{true};              // 是否启用Keep-Alive
     int keep_alive_timeout_{60};                 // Keep-Alive超时（秒）
+    size_t max_pipelined_requests_{128};         // 每次最多处理的流水线请求数
     bool http2_enabled_{false};                  // 是否启用HTTP/2
 
 #ifdef ENABLE_TLS
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "tzzero/net/socket_address.h"
+
 #include <functional>
 #include <string>
+#include <vector>
 #include <cstdint>
 
 namespace tzzero::core {
@@ -10,9 +13,17 @@ class EventLoop;
 
 namespace tzzero::net {
 
+// 一次 accept 得到的套接字；io_uring multishot accept 不返回对端地址，此时 peer 无效
+struct AcceptedSocket {
+    int fd;
+    SocketAddress peer;
+};
+
 class Acceptor {
 public:
-    using NewConnectionCallback = std::function<void(int sockfd, const std::string& peer_addr)>;
+    using NewConnectionCallback = std::function<void(AcceptedSocket& accepted)>;
+    // 回调返回后批次被清空，回调可以移走其中的元素
+    using NewConnectionsCallback = std::function<void(std::vector<AcceptedSocket>& batch)>;
 
     Acceptor(core::EventLoop* loop, const std::string& listen_addr, uint16_t port);
     ~Acceptor();
@@ -25,12 +36,33 @@ public:
         new_connection_callback_ = cb;
     }
 
+    // 设置后按批交付：一次可读事件 accept 到的所有套接字（io_uring 下为一轮循环内
+    // 完成的所有 accept）一起交给回调，优先于逐个回调
+    void set_new_connections_callback(const NewConnectionsCallback& cb) {
+        new_connections_callback_ = cb;
+    }
+
+    core::EventLoop* get_loop() const { return loop_; }
     bool listening() const { return listening_; }
+
+    // 绑定并开始监听但不注册到事件循环，可在任意线程调用；
+    // 同一端口的多个 SO_REUSEPORT 套接字按 bind 顺序组成组
+    void bind();
+
+    // 在 loop 线程中调用，未 bind 时先 bind
     void listen();
     void disable_listening();
 
+    // 为本套接字所在的 SO_REUSEPORT 组挂载 CBPF 程序，按收包 CPU 选择
+    // 第 (cpu % group_size) 个套接字；需先 bind，内核不支持时返回 false
+    bool attach_cpu_steering(size_t group_size);
+
 private:
     void handle_read();
+    void handle_accepted(int conn_fd);
+    void handle_accept_error(int saved_errno);
+    void deliver(AcceptedSocket& accepted);
+    void flush_batch();
     int create_nonblocking_socket();
     void bind_and_listen();
 
@@ -39,8 +71,11 @@ private:
     uint16_t port_;
     int accept_fd_;
     int idle_fd_;  // 保留文件描述符用于 EMFILE 保护
+    bool bound_;
     bool listening_;
     NewConnectionCallback new_connection_callback_;
+    NewConnectionsCallback new_connections_callback_;
+    std::vector<AcceptedSocket> batch_;  // 待交付的批次，复用容量
 
     static constexpr int kMaxAcceptPerLoop = 10000;
 };
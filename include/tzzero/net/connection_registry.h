@@ -0,0 +1,84 @@
+#pragma once
+
+#include "tzzero/net/tcp_connection.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace tzzero::net {
+
+// 单个 I/O 线程上的连接表
+//
+// 按整数槽位存放连接，槽位记在连接里，注册和注销都是 O(1) 的数组操作，
+// 不做字符串哈希。空出的槽位后进先出复用，表保持紧凑。
+// 只在所属循环线程访问。
+class ConnectionRegistry {
+public:
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    ConnectionRegistry() = default;
+
+    // 不可拷贝
+    ConnectionRegistry(const ConnectionRegistry&) = delete;
+    ConnectionRegistry& operator=(const ConnectionRegistry&) = delete;
+
+    void add(const TcpConnectionPtr& conn) {
+        uint32_t slot;
+        if (!free_slots_.empty()) {
+            slot = free_slots_.back();
+            free_slots_.pop_back();
+            slots_[slot] = conn;
+        } else {
+            slot = static_cast<uint32_t>(slots_.size());
+            slots_.push_back(conn);
+        }
+        conn->registry_slot_ = slot;
+        ++size_;
+    }
+
+    // 注销并返回表中持有的引用，未注册时返回空
+    TcpConnectionPtr remove(TcpConnection* conn) {
+        uint32_t slot = conn->registry_slot_;
+        if (slot == kNoSlot) {
+            return nullptr;
+        }
+        conn->registry_slot_ = kNoSlot;
+        free_slots_.push_back(slot);
+        --size_;
+        return std::move(slots_[slot]);
+    }
+
+    // 清空并返回所有连接
+    std::vector<TcpConnectionPtr> take_all() {
+        std::vector<TcpConnectionPtr> all;
+        all.reserve(size_);
+        for (TcpConnectionPtr& conn : slots_) {
+            if (conn) {
+                conn->registry_slot_ = kNoSlot;
+                all.push_back(std::move(conn));
+            }
+        }
+        slots_.clear();
+        free_slots_.clear();
+        size_ = 0;
+        return all;
+    }
+
+    template<typename F>
+    void for_each(F&& f) const {
+        for (const TcpConnectionPtr& conn : slots_) {
+            if (conn) {
+                f(conn);
+            }
+        }
+    }
+
+    size_t size() const { return size_; }
+
+private:
+    std::vector<TcpConnectionPtr> slots_;
+    std::vector<uint32_t> free_slots_;
+    size_t size_ = 0;
+};
+
+}  // namespace tzzero::net
@@ -14,6 +14,47 @@ class EventLoop;
 
 namespace tzzero::net {
 
+/**
+ * I/O 线程的 CPU 亲和性策略
+ */
+struct ThreadAffinity {
+    enum Mode {
+        NONE,             // 不绑定，由调度器决定
+        CORE_LIST,        // 按 cores 列表依次绑定，线程多于列表时循环使用
+        PHYSICAL_CORES    // 每个物理核一个线程（跳过超线程兄弟），先填满一个 NUMA 节点
+    };
+
+    Mode mode = NONE;
+    std::vector<int> cores;
+    bool numa_local = false;    // 线程内存优先本地节点，连接缓冲在 I/O 线程中分配
+
+    static ThreadAffinity core_list(std::vector<int> cores, bool numa_local = false) {
+        ThreadAffinity affinity;
+        affinity.mode = CORE_LIST;
+        affinity.cores = std::move(cores);
+        affinity.numa_local = numa_local;
+        return affinity;
+    }
+
+    static ThreadAffinity physical_cores(bool numa_local = false) {
+        ThreadAffinity affinity;
+        affinity.mode = PHYSICAL_CORES;
+        affinity.numa_local = numa_local;
+        return affinity;
+    }
+};
+
+/**
+ * 新连接分配到 I/O 线程的策略
+ */
+enum class LoadBalance {
+    ROUND_ROBIN,         // 轮询
+    LEAST_CONNECTIONS,   // 活跃连接最少的线程
+    POWER_OF_TWO,        // 随机取两个线程，选连接数和近期繁忙度综合负载较低者；
+                         // 关闭了运行统计的线程没有繁忙度，只按连接数计
+    PEER_HASH            // 按对端地址哈希，同一客户端固定到同一线程
+};
+
 /**
  * EventLoop线程封装
  * 每个线程运行一个独立的EventLoop
@@ -22,7 +63,11 @@ class EventLoopThread {
 public:
     using ThreadInitCallback = std::function<void(core::EventLoop*)>;
 
-    EventLoopThread(const ThreadInitCallback& cb = ThreadInitCallback{});
+    /**
+     * cpu >= 0 时线程启动后先绑定到该 CPU，再创建 EventLoop
+     */
+    EventLoopThread(const ThreadInitCallback& cb = ThreadInitCallback{},
+                    int cpu = -1, bool numa_local = false);
     ~EventLoopThread();
 
     // 禁止拷贝
@@ -43,6 +88,8 @@ private:
     std::mutex mutex_;
     std::condition_variable cond_;
     ThreadInitCallback callback_;
+    int cpu_;
+    bool numa_local_;
 };
 
 /**
@@ -65,21 +112,57 @@ public:
      */
     void set_thread_num(int num_threads) { num_threads_ = num_threads; }
 
+    /**
+     * 设置亲和性策略（必须在start之前调用）
+     */
+    void set_affinity(const ThreadAffinity& affinity) { affinity_ = affinity; }
+
+    /**
+     * 设置连接分配策略，默认轮询（必须在start之前调用）
+     */
+    void set_load_balance(LoadBalance strategy) { strategy_ = strategy; }
+    LoadBalance load_balance() const { return strategy_; }
+
     /**
      * 启动所有工作线程
      */
     void start(const ThreadInitCallback& cb = ThreadInitCallback{});
 
     /**
-     * 获取下一个EventLoop（Round-Robin）
+     * 按策略选出下一个EventLoop，只在主线程调用
+     * peer_hash 为对端地址的哈希，仅 PEER_HASH 使用
+     */
+    core::EventLoop* get_next_loop(size_t peer_hash = 0);
+
+    /**
+     * 第 index 个工作线程的负载：连接数（含已分配但尚未建立的）按近期繁忙度放大，
+     * 该线程关闭了运行统计时只取连接数
      */
-    core::EventLoop* get_next_loop();
+    double loop_load(size_t index) const;
+
+    /**
+     * 所有处理连接的EventLoop，未设置线程时只有主EventLoop
+     */
+    std::vector<core::EventLoop*> get_all_loops() const;
 
 private:
+    // 按策略为每个线程选定 CPU，-1 表示不绑定
+    std::vector<int> plan_cpus() const;
+
+    // 已分配给第 index 个线程、含尚未在该线程建立的连接数
+    int64_t loop_connections(size_t index) const;
+
+    size_t least_connections();
+    size_t power_of_two();
+
     core::EventLoop* base_loop_;  // 主EventLoop
     bool started_;                 // 是否已启动
     int num_threads_;              // 线程数
     int next_;                     // 下一个线程索引
+    ThreadAffinity affinity_;      // 亲和性策略
+    LoadBalance strategy_;         // 连接分配策略
+    uint64_t rng_state_;           // POWER_OF_TWO 的随机数状态
+    std::vector<uint64_t> dispatched_;  // 分配给每个线程的连接累计数，只在主线程访问
     std::vector<std::unique_ptr<EventLoopThread>> threads_;  // 线程列表
     std::vector<core::EventLoop*> loops_;                    // EventLoop列表
 };
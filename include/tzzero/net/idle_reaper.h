@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+namespace tzzero::core {
+class EventLoop;
+}
+
+namespace tzzero::net {
+
+class TcpConnection;
+
+// 单个 EventLoop 上的空闲连接回收器
+//
+// 连接按最近活动时间串成侵入式双向链表，有读写时移到表尾，只改几个指针，
+// 不为每次请求创建或取消定时器。每个循环只挂一个周期定时器，到点时从表头
+// 扫描，把超时的连接一次性摘下再逐个关闭，遇到第一个未超时的连接即停止。
+// 上层有请求在处理的连接暂时摘下（TcpConnection::pause_idle_timeout），不参与计时。
+// 除 reaped() 外只在所属循环线程访问。
+class IdleReaper : public std::enable_shared_from_this<IdleReaper> {
+public:
+    IdleReaper(core::EventLoop* loop, double timeout_seconds);
+    ~IdleReaper();
+
+    // 不可拷贝
+    IdleReaper(const IdleReaper&) = delete;
+    IdleReaper& operator=(const IdleReaper&) = delete;
+
+    // 注册扫描定时器，检查间隔为超时时间，但不超过 1 秒
+    // 可在任意线程调用；对象须由 shared_ptr 持有
+    void start();
+    void stop();
+
+    void add(TcpConnection* conn);
+    void touch(TcpConnection* conn);
+    void remove(TcpConnection* conn);
+
+    core::EventLoop* get_loop() const { return loop_; }
+    int64_t timeout_ns() const { return timeout_ns_; }
+    size_t size() const { return size_; }
+
+    // 累计因空闲被关闭的连接数，可在任意线程读取
+    uint64_t reaped() const { return reaped_.load(std::memory_order_relaxed); }
+
+private:
+    void reap();
+    void unlink(TcpConnection* conn);
+
+    core::EventLoop* loop_;
+    const int64_t timeout_ns_;
+    uint64_t timer_id_;
+
+    TcpConnection* head_;       // 最久未活动
+    TcpConnection* tail_;       // 最近活动
+    size_t size_;
+
+    std::vector<std::shared_ptr<TcpConnection>> batch_;  // 复用，避免每次扫描分配
+    std::atomic<uint64_t> reaped_;
+};
+
+}  // namespace tzzero::net
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+#include <sys/types.h>
+
+namespace tzzero::net {
+
+// 文件段引用的已打开文件，最后一个持有者释放时关闭
+class OpenFile {
+public:
+    explicit OpenFile(int fd) : fd_(fd) {}
+    ~OpenFile();
+
+    // 不可拷贝
+    OpenFile(const OpenFile&) = delete;
+    OpenFile& operator=(const OpenFile&) = delete;
+
+    int fd() const { return fd_; }
+
+private:
+    int fd_;
+};
+
+// 连接的 MSG_ZEROCOPY 发送状态
+//
+// 零拷贝发送时内核直接引用用户内存，直到从套接字错误队列读到完成通知之前，
+// 这段内存既不能释放也不能改写。每次成功的零拷贝发送按顺序编号，发完出队的段
+// 按最近一次发送的序号暂存在这里，通知到达后释放。TCP 的发送按序完成，
+// 通知给出的是已完成序号区间，释放不超过区间上界的所有暂存段即可。
+// 连接关闭不会让内核停止引用：套接字关闭后仍可能发送和重传这些数据，页面引用计数
+// 只保证页面不被解除映射，挡不住分配器把内存交给别的连接的响应。所以暂存的数据
+// 一直保留到通知覆盖全部发送，连接断开后由连接所属循环接着读取通知。
+// 只在连接所属线程访问
+class ZeroCopyState {
+public:
+    // 段太小时页面锁定和通知的开销超过复制，也保证参与零拷贝的字符串数据都在堆上
+    static constexpr size_t kMinThreshold = 4096;
+
+    explicit ZeroCopyState(size_t threshold);
+
+    // 不可拷贝
+    ZeroCopyState(const ZeroCopyState&) = delete;
+    ZeroCopyState& operator=(const ZeroCopyState&) = delete;
+
+    // 剩余字节不少于阈值的内存段用零拷贝发送
+    size_t threshold() const { return threshold_; }
+    // 是否有发出但还没收到完成通知的零拷贝发送
+    bool outstanding() const { return completed_ != issued_; }
+    size_t pinned() const { return pins_.size(); }
+
+    // 读空错误队列中的完成通知并释放已完成发送引用的数据，返回读到的通知数
+    int read_completions(int fd);
+    // 再也读不到通知（如循环已销毁）时放弃暂存的数据：内核可能仍在引用，
+    // 宁可泄漏也不释放
+    void abandon();
+
+    // 统计：零拷贝发送次数，完成的发送次数，其中内核退回复制的次数
+    // （如回环或网卡不支持分散收集时，数据仍被复制，只多了通知的开销）
+    uint64_t sends() const { return sends_; }
+    uint64_t completions() const { return completions_; }
+    uint64_t copied() const { return copied_; }
+
+private:
+    friend class OutputQueue;
+
+    struct Pin {
+        uint32_t seq;                       // 最后引用这段数据的发送序号
+        std::string owned;
+        std::shared_ptr<const void> keep;
+    };
+
+    void sent() {
+        ++issued_;
+        ++sends_;
+    }
+    // 暂存零拷贝发出的段的数据，直到当前最后一次发送完成
+    void pin(std::string&& owned, std::shared_ptr<const void>&& keep);
+
+    size_t threshold_;
+    uint32_t issued_ = 0;       // 已发出的零拷贝发送数，也是下一次发送的序号
+    uint32_t completed_ = 0;    // 已完成的发送数
+    std::deque<Pin> pins_;
+    uint64_t sends_ = 0;
+    uint64_t completions_ = 0;
+    uint64_t copied_ = 0;
+};
+
+// 连接的输出队列
+//
+// 待发数据按段排队，不拼接成一块连续内存：
+// - 复制进来的字节，以及接管的 std::string，数据放在段自己的字符串中；
+// - 共享的不可变数据（shared_ptr 持有，发完释放引用）；
+// - 静态数据（string_view，调用方保证在发完之前有效，如字面量）；
+// - 文件区间（已打开的文件、偏移和长度），用 sendfile 从页缓存直接发出，不读进内存。
+// 可写时用一次 writev 发出队首最多 IOV_MAX 个内存段，队首是文件段时调用一次 sendfile；
+// 这一批之后还有段时带 MSG_MORE 发送，多次调用写出的数据由内核合并成整段报文。
+// 开启零拷贝时，剩余字节达到阈值的内存段单独用 MSG_ZEROCOPY 发出，发完后数据交给
+// ZeroCopyState 暂存到完成通知到达。
+// 只有复制进来的数据会并入尾部的小字符串段，其他数据各自成段，不为减少 iovec 而复制。
+// 段数组从当前线程的帧池按需分配；只在连接所属线程访问，可整体移动到其他线程后再交给连接。
+class OutputQueue {
+public:
+    static constexpr size_t kCoalesceLimit = 4096;   // 尾段字符串超过此大小不再扩容并入
+#ifdef IOV_MAX
+    static constexpr int kMaxIovecs = IOV_MAX;       // 单次 writev 的段数上限
+#else
+    static constexpr int kMaxIovecs = 1024;
+#endif
+
+    OutputQueue() = default;
+    ~OutputQueue();
+
+    // 不可拷贝，可移动
+    OutputQueue(const OutputQueue&) = delete;
+    OutputQueue& operator=(const OutputQueue&) = delete;
+    OutputQueue(OutputQueue&& other) noexcept;
+    OutputQueue& operator=(OutputQueue&& other) noexcept;
+
+    // 以下追加操作返回复制的字节数
+    // 复制数据，能放进尾部字符串段时并入
+    size_t append(const void* data, size_t len);
+    // 接管字符串，从 offset 开始发送
+    size_t append(std::string&& data, size_t offset = 0);
+    // 共享不可变数据，从 offset 开始发送
+    size_t append_shared(std::shared_ptr<const std::string> blob, size_t offset = 0);
+    // 静态数据，不复制也不持有
+    size_t append_static(std::string_view data);
+    // 文件中 [offset, offset + len) 的内容，持有文件直到发完
+    size_t append_file(std::shared_ptr<const OpenFile> file, off_t offset, size_t len);
+    // 按顺序移入另一个队列的全部数据，other 变为空
+    size_t append(OutputQueue&& other);
+
+    size_t size() const { return bytes_; }
+    bool empty() const { return bytes_ == 0; }
+    size_t slices() const { return count_; }
+
+    // 一次 writev 写出队首的内存段，或一次 sendfile 写出队首的文件段
+    // 返回写入的字节数，出错时返回 -1 并设置 saved_errno；attempted 为这次请求写出的字节数，
+    // 写入少于它说明发送缓冲已满。文件比声明的短时按 EIO 出错。
+    // zerocopy 非空时，达到其阈值的内存段用 MSG_ZEROCOPY 发送
+    ssize_t write_to(int fd, int* saved_errno, size_t* attempted = nullptr,
+                     ZeroCopyState* zerocopy = nullptr);
+
+    // 丢弃所有数据；zerocopy 非空时，零拷贝发出过一部分的段把数据交给它暂存
+    void clear(ZeroCopyState* zerocopy = nullptr);
+
+private:
+    struct Slice {
+        const char* base = nullptr;   // 共享或静态数据；为空时数据在 owned 中
+        size_t offset = 0;            // 已发送的字节；文件段为下一个要发送的文件偏移
+        size_t len = 0;               // 总长度；文件段为结束偏移
+        int file_fd = -1;             // 文件段的文件，-1 表示内存段
+        bool zerocopy = false;        // 有部分数据经零拷贝发出，出队时须暂存
+        std::string owned;
+        std::shared_ptr<const void> keep;
+
+        const char* data() const { return (base != nullptr ? base : owned.data()) + offset; }
+        size_t remaining() const { return len - offset; }
+    };
+
+    Slice& push_back();
+    // zerocopy 非空时，零拷贝发出过的段把数据交给它暂存
+    void pop_front(ZeroCopyState* zerocopy = nullptr);
+    void consume(size_t n, ZeroCopyState* zerocopy);
+    void grow();
+    // 复制并入尾部的小字符串段，尾段不合适时返回 false
+    bool coalesce(const char* data, size_t len);
+    Slice& at(uint32_t i) { return ring_[(head_ + i) & (capacity_ - 1)]; }
+
+    Slice* ring_ = nullptr;     // 容量为 2 的幂的环形数组
+    uint32_t capacity_ = 0;
+    uint32_t head_ = 0;
+    uint32_t count_ = 0;
+    size_t bytes_ = 0;
+};
+
+}  // namespace tzzero::net
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <string>
+#include <cstddef>
+
+namespace tzzero::net {
+
+// 原始套接字地址
+//
+// 直接保存 accept4 / getpeername 填入的 sockaddr_storage，不做任何格式化，
+// 需要字符串时再调用 to_string()。未知地址的 family 为 AF_UNSPEC。
+class SocketAddress {
+public:
+    SocketAddress() : len_(0) { storage_.ss_family = AF_UNSPEC; }
+
+    static SocketAddress local_of(int sockfd);
+    static SocketAddress peer_of(int sockfd);
+
+    bool valid() const { return storage_.ss_family != AF_UNSPEC; }
+    sa_family_t family() const { return storage_.ss_family; }
+
+    // 供 accept4 等系统调用直接填写
+    sockaddr* data() { return reinterpret_cast<sockaddr*>(&storage_); }
+    const sockaddr* data() const { return reinterpret_cast<const sockaddr*>(&storage_); }
+    socklen_t* length() { return &len_; }
+    socklen_t capacity() const { return sizeof(storage_); }
+
+    // "ip:port"，IPv6 为 "[ip]:port"，未知地址为空串
+    std::string to_string() const;
+
+    // 只哈希 IP 部分，同一客户端的不同连接哈希相同
+    size_t hash_ip() const;
+
+private:
+    sockaddr_storage storage_;
+    socklen_t len_;
+};
+
+}  // namespace tzzero::net
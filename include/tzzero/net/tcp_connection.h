@@ -1,12 +1,17 @@
 #pragma once
 
 #include "tzzero/utils/buffer.h"
+#include "tzzero/net/output_queue.h"
+#include "tzzero/net/socket_address.h"
 
 #include <memory>
 #include <functional>
 #include <string>
+#include <string_view>
 #include <atomic>
+#include <mutex>
 #include <any>
+#include <cstdint>
 
 namespace tzzero::core {
 class EventLoop;
@@ -14,21 +19,30 @@ class EventLoop;
 
 namespace tzzero::net {
 
-class TcpConnection : public std::enable_shared_from_this<TcpConnection> {
+class IdleReaper;
+class ConnectionRegistry;
+struct ConnectionCallbacks;
+
+// 字段按访问频率排列：读写事件路径上的状态集中在对象开头三条对齐的缓存行
+// （分发状态、两个缓冲、空闲计时和上下文），名字、地址等冷数据排在后面，
+// 热路径不会把它们带进缓存
+class alignas(64) TcpConnection : public std::enable_shared_from_this<TcpConnection> {
 public:
     using MessageCallback = std::function<void(const std::shared_ptr<TcpConnection>&, tzzero::utils::Buffer&)>;    
     using CloseCallback = std::function<void(const std::shared_ptr<TcpConnection>&)>;
     using WriteCompleteCallback = std::function<void(const std::shared_ptr<TcpConnection>&)>;
     using HighWaterMarkCallback = std::function<void(const std::shared_ptr<TcpConnection>&, size_t)>;
 
-    enum State {
+    enum State : uint8_t {
         CONNECTING,
         CONNECTED,
         DISCONNECTING,
         DISCONNECTED
     };
 
-    TcpConnection(core::EventLoop* loop, const std::string& name, int sockfd);
+    // peer 为 accept 得到的对端地址，未知时在首次查询时 getpeername
+    TcpConnection(core::EventLoop* loop, uint64_t id, int sockfd,
+                  const SocketAddress& peer = SocketAddress{});
     ~TcpConnection();
 
     // 不可拷贝
@@ -40,37 +54,70 @@ public:
     bool connected() const { return state_ == CONNECTED; }
     bool disconnected() const { return state_ == DISCONNECTED; }
 
-    // 连接信息
-    const std::string& get_name() const { return name_; }
+    // 连接信息；字符串形式在首次调用时生成，之后复用，可在任意线程调用
+    uint64_t get_id() const { return id_; }
+    const std::string& get_name() const;
     int get_fd() const { return socket_fd_; }
     core::EventLoop* get_loop() const { return loop_; }
-    const std::string& get_local_address() const { return local_addr_; }
-    const std::string& get_peer_address() const { return peer_addr_; }
+    const SocketAddress& get_peer() const;
+    const std::string& get_local_address() const;
+    const std::string& get_peer_address() const;
 
     // 输入输出操作
+    // 消息回调中的发送先排进输出队列，回调返回后一次写出，流水线请求的多个响应
+    // 合并成一次 writev；其他时候输出队列为空时立即写
+    // 复制数据：输出队列为空时先直接写，只复制没写完的部分
     void send(const void* data, size_t len);
     void send(const std::string& message);
     void send(tzzero::utils::Buffer& buffer);
+    // 不复制数据：字符串被接管；共享数据持有引用直到发完；静态数据须在发完之前有效
+    void send(std::string&& message);
+    void send_shared(std::shared_ptr<const std::string> blob);
+    void send_static(std::string_view data);
+    // 文件区间用 sendfile 发出，持有文件直到发完；发送缓冲满时随可写事件继续
+    void send_file(std::shared_ptr<const OpenFile> file, off_t offset, size_t len);
+    // 按顺序发出一组段（如响应头和正文），与已排队的数据在同一次 writev 中写出
+    void send(OutputQueue&& pieces);
     void shutdown();
     void force_close();
 
-    // 回调函数
-    void set_message_callback(const MessageCallback& cb) { message_callback_ = cb; }
-    void set_close_callback(const CloseCallback& cb) { close_callback_ = cb; }
-    void set_write_complete_callback(const WriteCompleteCallback& cb) { write_complete_callback_ = cb; }
+    // 回调函数；消息、关闭和写完成回调由服务器按I/O线程构造一份，
+    // 线程内的连接共用，须比连接的注册活得久，在 connection_established 之前设置
+    void set_callbacks(const ConnectionCallbacks* callbacks) { callbacks_ = callbacks; }
     void set_high_water_mark_callback(const HighWaterMarkCallback& cb, size_t high_water_mark);
     
     // 连接管理
+    // 建立时连接持有自身引用，所属线程上的回调借用它而不再增减原子计数；
+    // connection_destroyed 最后释放，此后连接的寿命只取决于外部持有者
     void connection_established();
     void connection_destroyed();
 
     // 缓冲区管理
     tzzero::utils::Buffer& get_input_buffer() { return input_buffer_; }
-    tzzero::utils::Buffer& get_output_buffer() { return output_buffer_; }
+    OutputQueue& get_output_queue() { return output_queue_; }
 
     // TCP 选项
     void set_tcp_no_delay(bool on);
     void set_keep_alive(bool on);
+    // SO_BUSY_POLL / SO_PREFER_BUSY_POLL，内核或权限不支持时忽略
+    void set_busy_poll(int usec);
+    // 剩余字节不少于 bytes（最小 4KB）的内存段用 MSG_ZEROCOPY 发送，0 关闭；
+    // 须在所属线程发送之前调用，内核不支持 SO_ZEROCOPY 时忽略。
+    // 完成通知随 EPOLLERR 在同一次轮询中读取
+    void set_zerocopy_threshold(size_t bytes);
+    const ZeroCopyState* zerocopy() const { return zerocopy_.get(); }
+
+    // 边缘触发模式，须在 connection_established 之前设置
+    // 读写事件一次注册，之后不再修改关注的事件；读写都排空到 EAGAIN
+    void set_edge_triggered(bool on) { edge_triggered_ = on; }
+    bool edge_triggered() const { return edge_triggered_; }
+
+    // 空闲超时回收，须在 connection_established 之前设置；回收器须比连接的注册活得久
+    void set_idle_reaper(IdleReaper* reaper) { idle_reaper_ = reaper; }
+    // 上层还有请求在处理（如转交工作线程或等待协程）时暂停空闲计时，连接不会被回收；
+    // 恢复时重新从现在计时。只在所属线程调用，重复调用无副作用
+    void pause_idle_timeout();
+    void resume_idle_timeout();
 
     // 用于存储连接特定数据的上下文
     void set_context(const std::any& context) { context_ = context; }
@@ -78,32 +125,83 @@ public:
     std::any& get_mutable_context() { return context_; }
 
 private:
+    friend class IdleReaper;
+    friend class ConnectionRegistry;
+
+    void handle_event(uint32_t events);
     void handle_read();
     void handle_write();
     void handle_close();
     void handle_error();
+    // 读取零拷贝完成通知；错误事件只由通知引起时返回 true
+    bool handle_zerocopy_completions();
 
     void send_in_loop(const void* data, size_t len);
+    // 在循环线程中把数据排进输出队列，append 返回复制的字节数
+    template<typename Append>
+    void enqueue_in_loop(Append&& append);
+    // 数据已进入输出队列：检查高水位，原先队列为空时立即写一次（读事件分发中推迟到
+    // 分发结束），否则等可写事件
+    void queued(size_t old_len);
+    // 用 writev 写出输出队列，写完时通知并完成挂起的半关闭，没写完时关注可写事件
+    // 出错返回 false
+    bool write_output();
     void shutdown_in_loop();
     void force_close_in_loop();
 
+    // 关注事件的缓存，未变化时不调用 epoll_ctl
+    void enable_writing();
+    void disable_writing();
+    void update_interest(uint32_t events);
+
+    // 状态变为 DISCONNECTED 时调用：从空闲链表摘除、交出未完成的零拷贝发送并更新循环的连接计数
+    void on_disconnected();
+
+    // ---- 第一条缓存行（前 16 字节是 enable_shared_from_this）：事件分发 ----
     core::EventLoop* loop_;
-    const std::string name_;
-    State state_;
+    const ConnectionCallbacks* callbacks_;
+    std::shared_ptr<TcpConnection> self_;  // 所属线程持有的自身引用，只在该线程读写
     int socket_fd_;
-    std::string local_addr_;
-    std::string peer_addr_;
-
-    tzzero::utils::Buffer input_buffer_;
-    tzzero::utils::Buffer output_buffer_;
+    State state_;
+    bool edge_triggered_;
+    bool idle_linked_;          // 空闲链表节点，由 IdleReaper 维护
+    bool batching_;             // 正在分发读事件，发送只排队，分发结束时一起写出
+    uint32_t interest_;         // 当前注册到轮询器的事件
+
+    // ---- 第二条缓存行：读缓冲和输出队列 ----
+    alignas(64) tzzero::utils::Buffer input_buffer_;
+    OutputQueue output_queue_;
+
+    // ---- 第三条缓存行：空闲计时和链表、上下文 ----
+    alignas(64) IdleReaper* idle_reaper_;
+    int64_t last_active_ns_;
+    TcpConnection* idle_prev_;
+    TcpConnection* idle_next_;
+    std::any context_;
     size_t high_water_mark_;
+    std::shared_ptr<ZeroCopyState> zerocopy_;   // 未开启零拷贝时为空；断开后可能仍由循环持有
+
+    // ---- 冷数据 ----
+    alignas(64) const uint64_t id_;
+    uint32_t registry_slot_;    // 在所属 I/O 线程连接表中的槽位，由 ConnectionRegistry 维护
+
+    HighWaterMarkCallback high_water_mark_callback_;  // 很少设置
+    // 地址和名字按需生成
+    mutable SocketAddress peer_;
+    mutable std::string name_;
+    mutable std::string local_addr_;
+    mutable std::string peer_addr_;
+    mutable std::once_flag name_once_;
+    mutable std::once_flag local_once_;
+    mutable std::once_flag peer_once_;
+    mutable std::once_flag peer_addr_once_;
+};
 
-    MessageCallback message_callback_;
-    CloseCallback close_callback_;
-    WriteCompleteCallback write_complete_callback_;
-    HighWaterMarkCallback high_water_mark_callback_;
-
-    std::any context_;
+// 同一I/O线程上的连接共用的一组回调
+struct ConnectionCallbacks {
+    TcpConnection::MessageCallback message;
+    TcpConnection::WriteCompleteCallback write_complete;
+    TcpConnection::CloseCallback close;
 };
 
 using TcpConnectionPtr = std::shared_ptr<TcpConnection>;
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "tzzero/net/tcp_connection.h"
+#include "tzzero/net/event_loop_thread_pool.h"
 #include <memory>
 #include <string>
 #include <functional>
 #include <unordered_map>
+#include <vector>
 #include <atomic>
 
 namespace tzzero::core {
@@ -14,7 +16,8 @@ class EventLoop;
 namespace tzzero::net {
 
 class Acceptor;
-class EventLoopThreadPool;
+class IdleReaper;
+struct AcceptedSocket;
 
 /**
  * TCP服务器
@@ -45,15 +48,72 @@ public:
     void stop();
 
     /**
-     * 设置工作线程数（必须在start之前调用）
+     * 设置工作线程数及其 CPU 亲和性（必须在start之前调用）
      */
-    void set_thread_num(int num_threads);
+    void set_thread_num(int num_threads, const ThreadAffinity& affinity = ThreadAffinity{});
+
+    /**
+     * 主线程 accept 时按批转交新连接：一次可读事件得到的连接按目标I/O线程分组，
+     * 每个线程只投递一个任务、最多唤醒一次。默认开启（必须在start之前调用）
+     */
+    void set_batch_accept(bool on) { batch_accept_ = on; }
+
+    /**
+     * 新连接分配到I/O线程的策略，默认轮询（必须在start之前调用）
+     * 每个I/O线程各自监听时由内核分配，此设置无效
+     */
+    void set_load_balance(LoadBalance strategy);
+
+    /**
+     * 新连接使用边缘触发模式（必须在start之前调用）
+     */
+    void set_edge_triggered(bool on) { edge_triggered_ = on; }
+
+    /**
+     * I/O 线程忙轮询预算（微秒，0 关闭），同时为新连接设置 SO_BUSY_POLL
+     * 必须在start之前调用
+     */
+    void set_busy_poll(int usec) { busy_poll_us_ = usec; }
+
+    /**
+     * 新连接对不小于该大小（字节）的待发段使用 MSG_ZEROCOPY，0 关闭
+     * 必须在start之前调用
+     */
+    void set_zerocopy_threshold(size_t bytes) { zerocopy_threshold_ = bytes; }
+
+    /**
+     * 连接空闲超过该时间（秒）后关闭，0 表示不限制（必须在start之前调用）
+     * 每个I/O线程一个回收器，读写活动刷新空闲时间
+     */
+    void set_idle_timeout(double seconds) { idle_timeout_ = seconds; }
+
+    /**
+     * 每个I/O线程各自监听（SO_REUSEPORT），在本线程内 accept 并建立连接，
+     * 不经过主线程转交；未设置工作线程时无效（必须在start之前调用）
+     * cpu_steering 为 true 时挂载 CBPF 程序，按收包 CPU 选择监听套接字，
+     * 适合第 i 个I/O线程绑定在 CPU i 上且网卡队列中断分散到这些 CPU 的部署
+     */
+    void set_accept_per_loop(bool on, bool cpu_steering = false) {
+        accept_per_loop_ = on;
+        cpu_steering_ = cpu_steering;
+    }
+
+    /**
+     * 因空闲超时被关闭的连接总数，可在任意线程调用
+     */
+    uint64_t reaped_connections() const;
+
+    /**
+     * 每个I/O线程上的活跃连接数（按 get_all_loops 顺序），可在任意线程调用
+     */
+    std::vector<int64_t> connection_counts() const;
 
     const std::string& get_name() const { return name_; }
     const std::string& get_ip_port() const { return ip_port_; }
 
     /**
-     * 设置回调函数
+     * 设置回调函数（必须在start之前调用）
+     * 连接回调在连接建立后于其所属I/O线程中调用
      */
     void set_connection_callback(const ConnectionCallback& cb) {
         connection_callback_ = cb;
@@ -68,17 +128,41 @@ public:
     }
 
 private:
-    // 新连接到达
-    void new_connection(int sockfd, const std::string& peer_addr);
+    // 新连接到达（主线程 accept）
+    void new_connection(AcceptedSocket& accepted);
+
+    // 一批新连接到达（主线程 accept）
+    void new_connections(std::vector<AcceptedSocket>& batch);
+
+    // 新连接到达（I/O线程自行 accept）
+    void new_connection_in_loop(core::EventLoop* io_loop, AcceptedSocket& accepted);
+
+    // 按策略选择I/O线程
+    core::EventLoop* pick_loop(AcceptedSocket& accepted);
+
+    // 按 get_all_loops 顺序为每个I/O线程创建监听器
+    void start_loop_acceptors();
+
+    // 每个I/O线程的连接表、回收器、监听器和连接配置，只在该线程访问
+    struct LoopContext;
+    using LoopContextPtr = std::shared_ptr<LoopContext>;
+
+    // 在连接所属线程中创建连接并设置回调，不注册也不建立
+    static TcpConnectionPtr create_connection(LoopContext& context, const AcceptedSocket& accepted);
+
+    // 在连接所属线程中注册并建立连接，随后调用连接回调
+    static void establish(LoopContext& context, const TcpConnectionPtr& conn);
 
-    // 移除连接
-    void remove_connection(const TcpConnectionPtr& conn);
-    void remove_connection_in_loop(const TcpConnectionPtr& conn);
+    // 在连接所属线程中注销，不经过主线程
+    static void remove_connection(LoopContext& context, const TcpConnectionPtr& conn);
 
     core::EventLoop* loop_;                      // 主EventLoop
     const std::string ip_port_;                  // 监听地址:端口
     const std::string name_;                     // 服务器名称
+    const std::string listen_addr_;              // 监听地址
+    const uint16_t port_;                        // 监听端口
     std::unique_ptr<Acceptor> acceptor_;         // 连接接受器
+    std::vector<std::unique_ptr<Acceptor>> loop_acceptors_;  // 每个I/O线程的监听器，在线程池之前声明以便线程先退出
     std::unique_ptr<EventLoopThreadPool> thread_pool_;  // 工作线程池
 
     ConnectionCallback connection_callback_;      // 新连接回调
@@ -86,8 +170,14 @@ private:
     WriteCompleteCallback write_complete_callback_;  // 写完成回调
 
     std::atomic<bool> started_;                  // 是否已启动
-    int next_conn_id_;                           // 下一个连接ID
-    std::unordered_map<std::string, TcpConnectionPtr> connections_;  // 连接映射
+    bool edge_triggered_;                        // 连接是否使用边缘触发
+    int busy_poll_us_;                           // 忙轮询预算（微秒）
+    size_t zerocopy_threshold_;                  // 零拷贝发送阈值（字节）
+    double idle_timeout_;                        // 空闲超时（秒）
+    bool batch_accept_;                          // 按批转交新连接
+    bool accept_per_loop_;                       // 每个I/O线程各自监听
+    bool cpu_steering_;                          // 按 CPU 选择监听套接字
+    std::unordered_map<core::EventLoop*, LoopContextPtr> loop_contexts_;  // 每个I/O线程的上下文，启动后不变
 };
 
 } // namespace tzzero::net
@@ -10,13 +10,14 @@
 namespace tzzero::utils {
 
 // 高性能缓冲区，支持零拷贝优化
+// 存储从当前线程的帧池分配，I/O 线程上关闭的连接留下的缓冲由下一个连接复用
 class Buffer {
 public:
     static constexpr size_t kCheapPrepend = 8;
     static constexpr size_t kInitialSize = 1024;
 
     explicit Buffer(size_t initial_size = kInitialSize);
-    ~Buffer() = default;
+    ~Buffer();
 
     // 可拷贝和可移动
     Buffer(const Buffer& other);
@@ -26,9 +27,9 @@ public:
 
     // 大小和容量
     size_t readable_bytes() const { return write_index_ - read_index_; }
-    size_t writable_bytes() const { return buffer_.size() - write_index_; }
+    size_t writable_bytes() const { return capacity_ - write_index_; }
     size_t prependable_bytes() const { return read_index_; }
-    size_t capacity() const { return buffer_.size(); }
+    size_t capacity() const { return capacity_; }
 
     // 数据访问
     const char* peek() const { return begin() + read_index_; }
@@ -93,12 +94,14 @@ public:
     void swap(Buffer& other) noexcept;
 
 private:
-    char* begin() { return buffer_.data(); }
-    const char* begin() const { return buffer_.data(); }
+    char* begin() { return data_; }
+    const char* begin() const { return data_; }
 
     void make_space(size_t len);
 
-    std::vector<char> buffer_;
+    // 不经 std::vector：不清零新空间，也没有逐字节构造和析构
+    char* data_;
+    size_t capacity_;
     size_t read_index_;
     size_t write_index_;
 };
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace tzzero::utils {
+
+// 每个 EventLoop 一份的时间缓存
+//
+// 循环每轮在 poll 返回后调用一次 update()，本轮内的定时器、响应序列化和日志
+// 都读取缓存值，不再各自调用 clock_gettime / gmtime / strftime。
+// HTTP Date 和日志用的本地时间字符串按秒渲染，一秒内最多刷新一次。
+// 只在所属线程访问，不需要同步。
+class CachedClock {
+public:
+    CachedClock();
+
+    // 不可拷贝
+    CachedClock(const CachedClock&) = delete;
+    CachedClock& operator=(const CachedClock&) = delete;
+
+    void update();
+
+    int64_t monotonic_ns() const { return monotonic_ns_; }
+    int64_t wall_ns() const { return wall_ns_; }
+
+    // "Sun, 06 Nov 1994 08:49:37 GMT"
+    std::string_view http_date() const { return std::string_view(http_date_, kHttpDateLen); }
+
+    // "2026-01-02 15:04:05"，本地时区，秒级
+    std::string_view local_time() const { return std::string_view(local_time_, kLocalTimeLen); }
+
+    // 绑定为当前线程的时钟，EventLoop 构造/析构时调用
+    void attach();
+    void detach();
+
+    // 当前线程绑定的时钟；没有时返回线程私有的后备时钟并即时刷新
+    static const CachedClock& current();
+
+    // 未缓存的单调时钟
+    static int64_t read_monotonic_ns();
+
+private:
+    static constexpr size_t kHttpDateLen = 29;
+    static constexpr size_t kLocalTimeLen = 19;
+
+    void render(int64_t seconds);
+
+    int64_t monotonic_ns_;
+    int64_t wall_ns_;
+    int64_t rendered_second_;
+    char http_date_[kHttpDateLen + 1];
+    char local_time_[kLocalTimeLen + 1];
+};
+
+}  // namespace tzzero::utils
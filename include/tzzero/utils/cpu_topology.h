@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace tzzero::utils {
+
+// 逻辑 CPU 的拓扑信息
+struct CpuInfo {
+    int cpu;            // 逻辑 CPU 编号
+    int core_id;        // 物理核（同一 package 内唯一）
+    int package_id;     // 物理插槽
+    int numa_node;      // NUMA 节点，无法确定时为 0
+};
+
+// 从 /sys 读取的 CPU 拓扑，只包含当前进程允许运行的 CPU
+class CpuTopology {
+public:
+    static CpuTopology detect();
+
+    const std::vector<CpuInfo>& cpus() const { return cpus_; }
+
+    // 每个物理核取一个逻辑 CPU（超线程兄弟只取编号最小的），按 NUMA 节点、物理核排序
+    std::vector<int> physical_cores() const;
+
+    // 不存在时返回 nullptr
+    const CpuInfo* find(int cpu) const;
+
+    int numa_node_of(int cpu) const;
+    int num_numa_nodes() const;
+    int num_packages() const;
+
+    // 形如 "2 package(s), 2 NUMA node(s), 32 core(s), 64 cpu(s)"
+    std::string summary() const;
+
+    // 解析 "0-3,8,10-11" 格式的 CPU 列表
+    static std::vector<int> parse_cpu_list(const std::string& text);
+
+    // 把当前线程绑定到指定 CPU
+    static bool pin_current_thread(int cpu);
+
+    // 当前线程的内存分配优先落在本地 NUMA 节点
+    static bool prefer_local_memory();
+
+private:
+    std::vector<CpuInfo> cpus_;
+};
+
+}  // namespace tzzero::utils
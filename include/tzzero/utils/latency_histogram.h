@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace tzzero::utils {
+
+// 对数分桶的延迟直方图（纳秒）
+//
+// 每个 2 的幂区间再分 8 个子桶，相对误差约 12.5%，覆盖完整的 uint64 范围
+// 单写者：record/reset 只能由同一个线程调用；其他线程可随时读取分位数，
+// 读到的是近似快照，不加锁
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 3;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kNumBuckets = (64 - kSubBits) * kSubBuckets + kSubBuckets;
+
+    LatencyHistogram() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // 不可拷贝
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t value) {
+        auto& bucket = buckets_[bucket_index(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void reset() {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t count() const {
+        uint64_t total = 0;
+        for (const auto& bucket : buckets_) {
+            total += bucket.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // 分位数（0-100），返回所在桶的上界；没有样本时返回 0
+    uint64_t percentile(double p) const {
+        uint64_t counts[kNumBuckets];
+        uint64_t total = 0;
+        for (int i = 0; i < kNumBuckets; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        if (total == 0) {
+            return 0;
+        }
+
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total) + 0.5);
+        if (rank == 0) {
+            rank = 1;
+        }
+        if (rank > total) {
+            rank = total;
+        }
+
+        uint64_t seen = 0;
+        for (int i = 0; i < kNumBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return bucket_upper_bound(i);
+            }
+        }
+        return bucket_upper_bound(kNumBuckets - 1);
+    }
+
+    static int bucket_index(uint64_t value) {
+        if (value < 2 * kSubBuckets) {
+            return static_cast<int>(value);
+        }
+        int exponent = 63 - __builtin_clzll(value);
+        int shift = exponent - kSubBits;
+        int sub = static_cast<int>((value >> shift) & (kSubBuckets - 1));
+        return shift * kSubBuckets + kSubBuckets + sub;
+    }
+
+    static uint64_t bucket_upper_bound(int index) {
+        if (index < 2 * kSubBuckets) {
+            return static_cast<uint64_t>(index);
+        }
+        int shift = index / kSubBuckets - 1;
+        uint64_t sub = static_cast<uint64_t>(index % kSubBuckets);
+        uint64_t upper = (kSubBuckets + sub + 1) << shift;
+        return upper == 0 ? UINT64_MAX : upper - 1;
+    }
+
+private:
+    std::atomic<uint64_t> buckets_[kNumBuckets];
+};
+
+}  // namespace tzzero::utils
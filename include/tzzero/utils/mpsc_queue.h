@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+
+namespace tzzero::utils {
+
+// 侵入式节点，元素类型需继承 MpscNode
+struct MpscNode {
+    std::atomic<MpscNode*> next{nullptr};
+};
+
+// 侵入式无锁多生产者单消费者队列（Vyukov 算法）
+// push 可在任意线程调用，只做一次 exchange，不加锁
+// pop 只能由唯一的消费者线程调用
+template<typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head_(&stub_), tail_(&stub_) {}
+    ~MpscQueue() = default;
+
+    // 不可拷贝
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T* node) {
+        push_node(static_cast<MpscNode*>(node));
+    }
+
+    // 队列为空或生产者正处于 push 中间时返回 nullptr
+    T* pop() {
+        MpscNode* tail = tail_;
+        MpscNode* next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &stub_) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            tail_ = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr) {
+            tail_ = next;
+            return static_cast<T*>(tail);
+        }
+
+        if (tail != head_.load(std::memory_order_acquire)) {
+            // 生产者已交换 head 但尚未链接 next
+            return nullptr;
+        }
+
+        push_node(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail_ = next;
+            return static_cast<T*>(tail);
+        }
+        return nullptr;
+    }
+
+    // 仅在消费者线程中可靠
+    bool empty() const {
+        return tail_ == &stub_ && stub_.next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    void push_node(MpscNode* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        MpscNode* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    alignas(64) std::atomic<MpscNode*> head_;   // 生产者端
+    alignas(64) MpscNode* tail_;                // 消费者端
+    MpscNode stub_;
+};
+
+}  // namespace tzzero::utils
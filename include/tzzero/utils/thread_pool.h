@@ -1,19 +1,35 @@
 #pragma once
 
+#include "tzzero/utils/work_stealing_deque.h"
+#include "tzzero/utils/bounded_mpmc_queue.h"
+
 #include <vector>
-#include <queue>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <future>
 #include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
 
 namespace tzzero::utils {
 
+// Work-stealing thread pool
+//
+// Each worker owns a Chase-Lev deque (tasks posted from inside the pool) and a
+// bounded MPMC inbox (tasks posted from outside). External submitters spread
+// over the inboxes round-robin from a per-thread cursor, so there is no shared
+// lock or hot counter. Idle workers steal from the other deques and inboxes
+// before going to sleep. Queues are bounded: post() waits for space, try_post()
+// reports it, and a worker whose own queues are full runs the task inline.
 class ThreadPool {
 public:
-    explicit ThreadPool(size_t num_threads);
+    using Task = std::function<void()>;
+
+    // queue_capacity is per worker, for the deque and the inbox each
+    explicit ThreadPool(size_t num_threads, size_t queue_capacity = 4096);
     ~ThreadPool();
 
     // Non-copyable
@@ -22,41 +38,75 @@ public:
 
     // Submit a task and return a future
     template<typename F, typename... Args>
-    auto submit(F&& f, Args&&... args) -> std::future<typename std::result_of<F(Args...)>::type>;
+    auto submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>;
+
+    // Fire-and-forget, no future or shared state. Waits while all queues are full.
+    // Exceptions escaping the task terminate the process, as with std::thread.
+    void post(Task task);
+
+    // Like post(), but returns false instead of waiting when all queues are full;
+    // task is left untouched on failure so the caller can run it elsewhere
+    bool try_post(Task&& task);
+
+    // Post a batch with at most one wake-up round; waits for space like post()
+    void post_bulk(std::vector<Task> tasks);
 
     // Get number of threads
-    size_t size() const { return threads_.size(); }
+    size_t size() const { return workers_.size(); }
+
+    // Approximate number of queued tasks
+    size_t pending() const;
 
-    // Stop the thread pool
+    // True when called from one of this pool's workers
+    bool in_worker_thread() const;
+
+    // Stop the thread pool; queued tasks still run and may post follow-up tasks
     void stop();
 
 private:
-    std::vector<std::thread> threads_;
-    std::queue<std::function<void()>> tasks_;
-    std::mutex queue_mutex_;
-    std::condition_variable condition_;
+    struct TaskNode {
+        Task fn;
+    };
+
+    struct alignas(64) Worker {
+        Worker(size_t capacity) : local(capacity), inbox(capacity) {}
+
+        WorkStealingDeque<TaskNode> local;   // pushed/popped by the owner only
+        BoundedMpmcQueue<TaskNode> inbox;    // fed by external submitters
+        std::thread thread;
+    };
+
+    void worker_loop(size_t index);
+    TaskNode* find_task(size_t index);
+    bool has_work() const;
+
+    bool enqueue(TaskNode* node, bool notify);
+    void enqueue_wait(TaskNode* node);
+    void wake(bool all);
+    void check_running() const;
+
+    static void run(TaskNode* node);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
     std::atomic<bool> stop_flag_;
+
+    alignas(64) std::atomic<int> sleeping_;
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cond_;
+    uint64_t wake_epoch_;
 };
 
 template<typename F, typename... Args>
-auto ThreadPool::submit(F&& f, Args&&... args) -> std::future<typename std::result_of<F(Args...)>::type> {
-    using return_type = typename std::result_of<F(Args...)>::type;
+auto ThreadPool::submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
+    using return_type = std::invoke_result_t<F, Args...>;
 
+    // std::function needs a copyable target, so the packaged_task is shared
     auto task = std::make_shared<std::packaged_task<return_type()>>(
         std::bind(std::forward<F>(f), std::forward<Args>(args)...)
     );
 
     std::future<return_type> result = task->get_future();
-
-    {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        if (stop_flag_) {
-            throw std::runtime_error("Cannot submit task to stopped ThreadPool");
-        }
-        tasks_.emplace([task](){ (*task)(); });
-    }
-
-    condition_.notify_one();
+    post([task]() { (*task)(); });
     return result;
 }
 
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace tzzero::utils {
+
+// 固定容量的 Chase-Lev 工作窃取双端队列（Lê 等人的 C11 内存序版本）
+//
+// 所有者线程在底部 push/pop（LIFO，缓存友好），其他线程从顶部 steal（FIFO）。
+// 元素是指针，槽位为原子变量，窃取者读到的旧值在 CAS 失败时直接丢弃。
+// 容量固定不扩容，满时 push 返回 false，由调用方决定退路。
+template<typename T>
+class WorkStealingDeque {
+public:
+    // capacity 向上取整为 2 的幂
+    explicit WorkStealingDeque(size_t capacity)
+        : mask_(round_up(capacity) - 1)
+        , buffer_(std::make_unique<std::atomic<T*>[]>(mask_ + 1))
+    {
+    }
+
+    // 不可拷贝
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // 仅所有者调用
+    bool push(T* item) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t > static_cast<int64_t>(mask_)) {
+            return false;
+        }
+        buffer_[b & mask_].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 仅所有者调用，空时返回 nullptr
+    T* pop() {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = buffer_[b & mask_].load(std::memory_order_relaxed);
+        if (t == b) {
+            // 只剩最后一个，与窃取者竞争
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // 任意线程调用，空或竞争失败时返回 nullptr
+    T* steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+
+        T* item = buffer_[t & mask_].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    // 近似值，仅用于统计和空闲判断
+    size_t size() const {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    static size_t round_up(size_t n) {
+        size_t cap = 2;
+        while (cap < n) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    alignas(64) std::atomic<int64_t> top_{0};      // 窃取端
+    alignas(64) std::atomic<int64_t> bottom_{0};   // 所有者端
+    const size_t mask_;
+    std::unique_ptr<std::atomic<T*>[]> buffer_;
+};
+
+}  // namespace tzzero::utils
@@ -26,20 +26,11 @@ int EpollPoller::poll(int timeout_ms, std::vector<PollEvent>& active_events) {
                                   static_cast<int>(events_.size()), timeout_ms);
     
     if (num_events > 0) {
-        active_events.reserve(num_events);
-        
         for (int i = 0; i < num_events; ++i) {
-            int fd = events_[i].data.fd;
-            uint32_t revents = epoll_to_events(events_[i].events);
-            
-            auto it = fd_callbacks_.find(fd);
-            if (it != fd_callbacks_.end()) {
-                PollEvent event;
-                event.fd = fd;
-                event.events = revents;
-                event.callback = it->second;
-                active_events.push_back(event);
-            }
+            // data.ptr 指向处理器表中的稳定地址，无需查表
+            auto* handler = static_cast<FdHandler*>(events_[i].data.ptr);
+            active_events.push_back({handler->fd(), epoll_to_events(events_[i].events),
+                                     handler, handler->epoch()});
         }
 
         if (static_cast<size_t>(num_events) == events_.size()) {
@@ -51,27 +42,31 @@ int EpollPoller::poll(int timeout_ms, std::vector<PollEvent>& active_events) {
 }
 
 void EpollPoller::add_fd(int fd, uint32_t events, std::function<void(int, uint32_t)> callback) {
+    FdHandler& handler = handlers_.get(fd);
+
     epoll_event event;
     event.events = events_to_epoll(events);
-    event.data.fd = fd;
+    event.data.ptr = &handler;
 
     if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
         throw std::runtime_error("epoll_ctl ADD failed");
     }
     
-    fd_callbacks_[fd] = std::move(callback);
+    handler.set(std::move(callback));
 }
 
 void EpollPoller::modify_fd(int fd, uint32_t events, std::function<void(int, uint32_t)> callback) {
+    FdHandler& handler = handlers_.get(fd);
+
     epoll_event event;
     event.events = events_to_epoll(events);
-    event.data.fd = fd;
+    event.data.ptr = &handler;
 
     if (::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event) < 0) {
         throw std::runtime_error("epoll_ctl MOD failed");
     }
     
-    fd_callbacks_[fd] = std::move(callback);
+    handler.set(std::move(callback));
 }
 
 void EpollPoller::remove_fd(int fd) {
@@ -79,7 +74,19 @@ void EpollPoller::remove_fd(int fd) {
         throw std::runtime_error("epoll_ctl DEL failed");
     }
     
-    fd_callbacks_.erase(fd);
+    if (FdHandler* handler = handlers_.find(fd)) {
+        handler->reset();
+    }
+}
+
+void EpollPoller::update_fd(int fd, uint32_t events) {
+    epoll_event event;
+    event.events = events_to_epoll(events);
+    event.data.ptr = &handlers_.get(fd);
+
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event) < 0) {
+        throw std::runtime_error("epoll_ctl MOD failed");
+    }
 }
 
 uint32_t EpollPoller::events_to_epoll(uint32_t events) const {
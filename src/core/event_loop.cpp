@@ -7,6 +7,7 @@
 #include <iostream>
 #include <cerrno>
 #include <cstring>
+#include <algorithm>
 
 namespace tzzero::core {
 
@@ -29,15 +30,21 @@ EventLoop::EventLoop()
     } else {
         t_loop_in_this_thread = this;
     }
+    clock_.attach();
+    frame_pool_.attach();
 
-    // 将唤醒文件描述符添加到轮询器
-    poller_->add_fd(wakeup_fd_, Poller::EVENT_READ, [this](int, uint32_t) {
+    // 将唤醒文件描述符添加到轮询器，read 会清零计数，可以使用边沿触发
+    poller_->add_fd(wakeup_fd_, Poller::EVENT_READ | Poller::EVENT_EDGE_TRIGGERED, [this](int, uint32_t) {
         handle_wake_up();
     });
 }
 
 EventLoop::~EventLoop() {
+    while (PendingTask* task = pending_tasks_.pop()) {
+        delete task;
+    }
     ::close(wakeup_fd_);
+    clock_.detach();
     t_loop_in_this_thread = nullptr;
 }
 
@@ -47,15 +54,26 @@ void EventLoop::loop() {
     
     looping_ = true;
     quit_ = false;
+    clock_.update();
 
     std::vector<PollEvent> active_events;
+    int64_t iteration_end = clock_.monotonic_ns();
     
     while (!quit_) {
         active_events.clear();
         
-        // 带超时轮询事件
-        int timeout_ms = timer_queue_->get_next_timeout();
-        int num_events = poller_->poll(timeout_ms, active_events);
+        int num_events;
+        if (spinning_) {
+            // 自旋期间不声明阻塞，生产者不会写 eventfd，任务在本轮末尾取出
+            num_events = poller_->poll(0, active_events);
+        } else {
+            // 先声明即将阻塞，再检查待执行任务；与 queue_in_loop 中
+            // "先入队再检查 polling_" 配对，保证不会漏掉唤醒
+            polling_.store(true);
+            int timeout_ms = pending_count_.load() > 0 ? 0 : timer_queue_->get_next_timeout();
+            num_events = poller_->poll(timeout_ms, active_events);
+            polling_.store(false, std::memory_order_relaxed);
+        }
         
         if (num_events < 0) {
             int saved_errno = errno;
@@ -70,20 +88,42 @@ void EventLoop::loop() {
             }
         }
 
+        // 本轮只读一次时钟
+        clock_.update();
+        bool stats_enabled = stats_enabled_.load(std::memory_order_relaxed);
+        int64_t poll_end = clock_.monotonic_ns();
+
         // 处理定时器事件
-        timer_queue_->process_expired_timers();
+        timer_queue_->process_expired_timers(poll_end);
+        int64_t timers_end = stats_enabled ? utils::CachedClock::read_monotonic_ns() : 0;
 
         // 处理 I/O 事件
         for (const auto& event : active_events) {
-            if (event.callback) {
-                event.callback(event.fd, event.events);
-            }
+            event.dispatch();
         }
+        int64_t io_end = stats_enabled ? utils::CachedClock::read_monotonic_ns() : 0;
 
         // 处理待执行的函数对象
-        do_pending_functors();
+        size_t queue_depth = pending_count_.load(std::memory_order_relaxed);
+        bool ran_tasks = do_pending_functors();
+
+        if (stats_enabled) {
+            int64_t functors_end = utils::CachedClock::read_monotonic_ns();
+            stats_.record_iteration(poll_end - iteration_end, timers_end - poll_end,
+                                    io_end - timers_end, functors_end - io_end,
+                                    static_cast<size_t>(num_events), queue_depth);
+            iteration_end = functors_end;
+        }
+
+        if (busy_poll_max_ns_ > 0) {
+            spinning_ = busy_poll_continue(num_events > 0 || ran_tasks);
+        }
     }
 
+    // quit 之前投递的任务（如服务器析构时交给本线程的连接销毁）可能排在退出的
+    // 这一轮之后，退出前再执行一遍，否则析构时只会被丢弃，连接和 fd 随之泄漏
+    do_pending_functors();
+
     looping_ = false;
 }
 
@@ -98,6 +138,10 @@ bool EventLoop::is_in_loop_thread() const {
     return thread_id_ == std::this_thread::get_id();
 }
 
+EventLoop* EventLoop::current() {
+    return t_loop_in_this_thread;
+}
+
 void EventLoop::run_in_loop(EventCallback cb) {
     if (is_in_loop_thread()) {
         cb();
@@ -107,13 +151,18 @@ void EventLoop::run_in_loop(EventCallback cb) {
 }
 
 void EventLoop::queue_in_loop(EventCallback cb) {
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pending_functors_.push_back(std::move(cb));
-    }
+    // 先计数再入队：消费者看到的计数不会小于可弹出的任务数
+    pending_count_.fetch_add(1);
+    // 只统计跨线程投递的唤醒延迟，循环线程自己投递的任务记 0 不计入
+    int64_t enqueue_ns = is_in_loop_thread() ? 0 : utils::CachedClock::read_monotonic_ns();
+    pending_tasks_.push(new PendingTask(std::move(cb), enqueue_ns));
 
-    // 简化版本 - 总是唤醒，效率不是最优但更安全
-    wake_up();
+    // 循环未阻塞时会在本轮结束前处理任务；已有未消费的唤醒时也无需重复写入
+    if (polling_.load() && !wakeup_pending_.exchange(true)) {
+        wake_up();
+    } else {
+        wakeups_saved_.fetch_add(1, std::memory_order_relaxed);
+    }
 }
 
 uint64_t EventLoop::run_after(double delay_seconds, EventCallback cb) {
@@ -129,6 +178,7 @@ void EventLoop::cancel_timer(uint64_t timer_id) {
 }
 
 void EventLoop::wake_up() {
+    wakeups_.fetch_add(1, std::memory_order_relaxed);
     uint64_t one = 1;
     ssize_t n = ::write(wakeup_fd_, &one, sizeof(one));
     // 暂时不处理写入失败的情况
@@ -140,23 +190,74 @@ void EventLoop::handle_wake_up() {
     ssize_t n = ::read(wakeup_fd_, &one, sizeof(one));
     // 暂时不处理读取失败的情况
     (void)n;
+    wakeup_pending_.store(false);
 }
 
-void EventLoop::do_pending_functors() {
-    std::vector<EventCallback> functors;
+bool EventLoop::do_pending_functors() {
+    // 只处理进入时已入队的任务，回调中新入队的留到下一轮
+    size_t count = pending_count_.load(std::memory_order_acquire);
+    if (count == 0) {
+        return false;
+    }
+
     calling_pending_functors_ = true;
+    int64_t now = clock_.monotonic_ns();
 
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        functors.swap(pending_functors_);
-    }
+    for (size_t i = 0; i < count; ++i) {
+        PendingTask* task = pending_tasks_.pop();
+        if (task == nullptr) {
+            // 生产者尚未完成链接，下一轮 poll 不会阻塞
+            break;
+        }
+        pending_count_.fetch_sub(1, std::memory_order_relaxed);
+        if (task->enqueue_ns != 0) {
+            wakeup_latency_.record(static_cast<uint64_t>(std::max<int64_t>(0, now - task->enqueue_ns)));
+        }
 
-    // 简单执行所有回调，不处理异常
-    for (const auto& functor : functors) {
-        functor();
+        // 简单执行所有回调，不处理异常
+        task->callback();
+        delete task;
     }
     
     calling_pending_functors_ = false;
+    return true;
+}
+
+void EventLoop::set_busy_poll(int budget_us) {
+    busy_poll_max_ns_ = budget_us > 0 ? static_cast<int64_t>(budget_us) * 1000 : 0;
+    // 空闲时最多退到上限的 1/64
+    busy_poll_min_ns_ = busy_poll_max_ns_ / 64;
+    spin_budget_ns_ = busy_poll_max_ns_;
+    spinning_ = false;
+    spin_found_work_ = false;
+}
+
+bool EventLoop::busy_poll_continue(bool had_work) {
+    int64_t now = clock_.monotonic_ns();
+
+    if (had_work) {
+        if (spinning_) {
+            spin_found_work_ = true;
+        }
+        spin_deadline_ns_ = now + spin_budget_ns_;
+        return true;
+    }
+
+    if (!spinning_) {
+        return false;
+    }
+    if (now < spin_deadline_ns_) {
+        return true;
+    }
+
+    // 自旋窗口耗尽，准备阻塞：自旋期间等到过事件则加大预算，否则减半
+    if (spin_found_work_) {
+        spin_budget_ns_ = std::min(busy_poll_max_ns_, spin_budget_ns_ * 2);
+    } else {
+        spin_budget_ns_ = std::max(busy_poll_min_ns_, spin_budget_ns_ / 2);
+    }
+    spin_found_work_ = false;
+    return false;
 }
 
 }  // namespace tzzero::core
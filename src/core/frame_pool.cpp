@@ -0,0 +1,104 @@
+#include "tzzero/core/frame_pool.h"
+#include <algorithm>
+#include <new>
+
+namespace tzzero::core {
+
+namespace {
+
+thread_local FramePool* t_current_pool = nullptr;
+
+// 所有块按缓存行对齐，池中块可以存放 alignas(64) 的对象，相邻对象也不共享缓存行
+constexpr std::align_val_t kAlignment{FramePool::kGranularity};
+
+}  // anonymous namespace
+
+FramePool::FramePool()
+    : free_lists_{}
+    , counts_{}
+    , allocations_(0)
+    , reused_(0)
+{
+}
+
+FramePool::~FramePool() {
+    detach();
+    for (size_t i = 0; i < kClasses; ++i) {
+        FreeBlock* block = free_lists_[i];
+        while (block != nullptr) {
+            FreeBlock* next = block->next;
+            ::operator delete(block, kAlignment);
+            block = next;
+        }
+    }
+}
+
+void FramePool::attach() {
+    t_current_pool = this;
+}
+
+void FramePool::detach() {
+    if (t_current_pool == this) {
+        t_current_pool = nullptr;
+    }
+}
+
+void* FramePool::allocate(size_t size) {
+    // 标准分配器可能请求 0 字节，按最小的尺寸类分配，释放时同样处理
+    size = std::max(size, kGranularity);
+    if (size > kMaxPooledSize) {
+        return ::operator new(size, kAlignment);
+    }
+    if (FramePool* pool = t_current_pool) {
+        return pool->pop(size);
+    }
+    // 按尺寸类分配，之后可以归还到任意线程的池
+    return ::operator new(class_size(class_of(size)), kAlignment);
+}
+
+void FramePool::deallocate(void* ptr, size_t size) noexcept {
+    size = std::max(size, kGranularity);
+    if (size <= kMaxPooledSize) {
+        if (FramePool* pool = t_current_pool) {
+            if (pool->push(ptr, size)) {
+                return;
+            }
+        }
+    }
+    ::operator delete(ptr, kAlignment);
+}
+
+size_t FramePool::cached() const {
+    size_t total = 0;
+    for (size_t i = 0; i < kClasses; ++i) {
+        total += counts_[i];
+    }
+    return total;
+}
+
+void* FramePool::pop(size_t size) {
+    size_t index = class_of(size);
+    ++allocations_;
+    FreeBlock* block = free_lists_[index];
+    if (block != nullptr) {
+        free_lists_[index] = block->next;
+        --counts_[index];
+        ++reused_;
+        return block;
+    }
+    return ::operator new(class_size(index), kAlignment);
+}
+
+bool FramePool::push(void* ptr, size_t size) noexcept {
+    size_t index = class_of(size);
+    if (counts_[index] >= kMaxCachedPerClass) {
+        return false;
+    }
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = free_lists_[index];
+    free_lists_[index] = block;
+    ++counts_[index];
+    return true;
+}
+
+}  // namespace tzzero::core
@@ -0,0 +1,416 @@
+#include "tzzero/core/io_uring_poller.h"
+#include "tzzero/core/event_loop.h"
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+namespace tzzero::core {
+
+namespace {
+
+// 取消/内部请求使用的 user_data，完成事件直接忽略
+constexpr uint64_t kInternalUserData = 0;
+
+// user_data 布局: [63] accept 标志 | [62:32] 代数 | [31:0] fd
+constexpr uint64_t kAcceptFlag = 1ull << 63;
+constexpr uint32_t kGenerationMask = 0x7fffffffu;
+
+int io_uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete,
+                   unsigned flags, const void* arg, size_t arg_size) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit,
+                                      min_complete, flags, arg, arg_size));
+}
+
+int create_ring(io_uring_params& params, unsigned sq_entries, unsigned cq_entries) {
+    // 优先使用单线程提交相关的优化标志，旧内核不支持时逐级退回
+    const unsigned flag_sets[] = {
+        IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL |
+            IORING_SETUP_COOP_TASKRUN | IORING_SETUP_SINGLE_ISSUER,
+        IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL,
+        IORING_SETUP_CQSIZE,
+    };
+
+    for (unsigned flags : flag_sets) {
+        memset(&params, 0, sizeof(params));
+        params.flags = flags;
+        params.cq_entries = cq_entries;
+        int fd = io_uring_setup(sq_entries, &params);
+        if (fd >= 0) {
+            return fd;
+        }
+        if (errno != EINVAL) {
+            break;
+        }
+    }
+    throw std::runtime_error(std::string("io_uring_setup failed: ") + strerror(errno));
+}
+
+}  // anonymous namespace
+
+IoUringPoller::IoUringPoller(EventLoop* loop)
+    : Poller(loop)
+    , ring_fd_(-1)
+    , sq_ring_ptr_(MAP_FAILED)
+    , sq_ring_size_(0)
+    , cq_ring_ptr_(MAP_FAILED)
+    , cq_ring_size_(0)
+    , sqes_(static_cast<io_uring_sqe*>(MAP_FAILED))
+    , sqes_size_(0)
+    , next_generation_(1)
+{
+    io_uring_params params;
+    ring_fd_ = create_ring(params, kSqEntries, kCqEntries);
+
+    if (!(params.features & IORING_FEAT_EXT_ARG)) {
+        ::close(ring_fd_);
+        throw std::runtime_error("io_uring lacks IORING_FEAT_EXT_ARG (kernel >= 5.11 required)");
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+
+    sq_ring_ptr_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ptr_ == MAP_FAILED) {
+        ::close(ring_fd_);
+        throw std::runtime_error("Failed to mmap io_uring SQ ring");
+    }
+
+    if (single_mmap) {
+        cq_ring_ptr_ = sq_ring_ptr_;
+    } else {
+        cq_ring_ptr_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ptr_ == MAP_FAILED) {
+            ::munmap(sq_ring_ptr_, sq_ring_size_);
+            ::close(ring_fd_);
+            throw std::runtime_error("Failed to mmap io_uring CQ ring");
+        }
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                                              MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+    if (sqes_ == MAP_FAILED) {
+        if (!single_mmap) {
+            ::munmap(cq_ring_ptr_, cq_ring_size_);
+        }
+        ::munmap(sq_ring_ptr_, sq_ring_size_);
+        ::close(ring_fd_);
+        throw std::runtime_error("Failed to mmap io_uring SQEs");
+    }
+
+    char* sq = static_cast<char*>(sq_ring_ptr_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+
+    char* cq = static_cast<char*>(cq_ring_ptr_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+}
+
+IoUringPoller::~IoUringPoller() {
+    ::munmap(sqes_, sqes_size_);
+    if (cq_ring_ptr_ != sq_ring_ptr_) {
+        ::munmap(cq_ring_ptr_, cq_ring_size_);
+    }
+    ::munmap(sq_ring_ptr_, sq_ring_size_);
+    // 关闭环会取消所有未完成的请求
+    ::close(ring_fd_);
+}
+
+int IoUringPoller::poll(int timeout_ms, std::vector<PollEvent>& active_events) {
+    rearm_pending();
+
+    // 已有完成事件时不阻塞，只提交
+    unsigned cq_ready = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE) - *cq_head_;
+    unsigned wait_nr = (cq_ready > 0 || timeout_ms == 0) ? 0 : 1;
+
+    struct __kernel_timespec ts;
+    const struct __kernel_timespec* ts_ptr = nullptr;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1000000;
+        ts_ptr = &ts;
+    }
+
+    int ret = submit(wait_nr, ts_ptr);
+    if (ret < 0 && errno != ETIME && errno != EBUSY && errno != EAGAIN) {
+        return -1;
+    }
+
+    size_t first = active_events.size();
+    reap(active_events);
+    return static_cast<int>(active_events.size() - first);
+}
+
+void IoUringPoller::add_fd(int fd, uint32_t events, std::function<void(int, uint32_t)> callback) {
+    FdEntry& entry = register_entry(fd);
+    entry.events = events;
+    entry.generation = next_generation();
+    entry.accept = false;
+    handlers_.get(fd).set(std::move(callback));
+    arm(fd, entry);
+}
+
+void IoUringPoller::modify_fd(int fd, uint32_t events, std::function<void(int, uint32_t)> callback) {
+    FdEntry* entry = find_entry(fd);
+    if (entry == nullptr) {
+        throw std::runtime_error("io_uring modify_fd on unregistered fd");
+    }
+
+    handlers_.get(fd).set(std::move(callback));
+    update_fd(fd, events);
+}
+
+void IoUringPoller::update_fd(int fd, uint32_t events) {
+    FdEntry* entry = find_entry(fd);
+    if (entry == nullptr) {
+        throw std::runtime_error("io_uring update_fd on unregistered fd");
+    }
+
+    if (entry->events == events) {
+        // 关注的事件未变，无需重新提交
+        return;
+    }
+
+    cancel(fd, *entry);
+    entry->events = events;
+    entry->generation = next_generation();
+    arm(fd, *entry);
+}
+
+void IoUringPoller::remove_fd(int fd) {
+    FdEntry* entry = find_entry(fd);
+    if (entry == nullptr) {
+        throw std::runtime_error("io_uring remove_fd on unregistered fd");
+    }
+
+    cancel(fd, *entry);
+    entry->registered = false;
+    handlers_.get(fd).reset();
+}
+
+bool IoUringPoller::add_accept_fd(int listen_fd, AcceptCallback callback) {
+    FdEntry& entry = register_entry(listen_fd);
+    entry.events = EVENT_READ;
+    entry.generation = next_generation();
+    entry.accept = true;
+
+    // 事件中的 fd 是新连接；包装只在注册时构造一次
+    handlers_.get(listen_fd).set([accept_cb = std::move(callback)](int conn_fd, uint32_t) {
+        accept_cb(conn_fd);
+    });
+    arm(listen_fd, entry);
+    return true;
+}
+
+IoUringPoller::FdEntry* IoUringPoller::find_entry(int fd) {
+    if (fd < 0 || static_cast<size_t>(fd) >= fd_entries_.size() || !fd_entries_[fd].registered) {
+        return nullptr;
+    }
+    return &fd_entries_[fd];
+}
+
+IoUringPoller::FdEntry& IoUringPoller::register_entry(int fd) {
+    if (find_entry(fd) != nullptr) {
+        throw std::runtime_error("io_uring add_fd on registered fd");
+    }
+    if (static_cast<size_t>(fd) >= fd_entries_.size()) {
+        fd_entries_.resize(std::max<size_t>(fd + 1, fd_entries_.size() * 2));
+    }
+
+    FdEntry& entry = fd_entries_[fd];
+    entry.registered = true;
+    return entry;
+}
+
+uint32_t IoUringPoller::next_generation() {
+    uint32_t generation = next_generation_;
+    next_generation_ = (next_generation_ + 1) & kGenerationMask;
+    if (next_generation_ == 0) {
+        next_generation_ = 1;
+    }
+    return generation;
+}
+
+io_uring_sqe* IoUringPoller::get_sqe() {
+    unsigned tail = *sq_tail_;
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+        // SQ 已满，先提交已有的请求
+        submit(0, nullptr);
+        if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+            throw std::runtime_error("io_uring submission queue overflow");
+        }
+    }
+
+    unsigned index = tail & sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    return sqe;
+}
+
+int IoUringPoller::submit(unsigned wait_nr, const struct __kernel_timespec* ts) {
+    unsigned to_submit = *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    unsigned flags = 0;
+
+    io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+
+    if (wait_nr > 0) {
+        flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = reinterpret_cast<uint64_t>(ts);
+        return io_uring_enter(ring_fd_, to_submit, wait_nr, flags, &arg, sizeof(arg));
+    }
+
+    if (to_submit == 0) {
+        return 0;
+    }
+    return io_uring_enter(ring_fd_, to_submit, 0, 0, nullptr, 0);
+}
+
+void IoUringPoller::arm(int fd, const FdEntry& entry) {
+    io_uring_sqe* sqe = get_sqe();
+    sqe->fd = fd;
+    sqe->user_data = make_user_data(fd, entry);
+
+    if (entry.accept) {
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+        return;
+    }
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->poll32_events = events_to_poll(entry.events);
+    if (entry.events & EVENT_EDGE_TRIGGERED) {
+        sqe->len = IORING_POLL_ADD_MULTI;
+    }
+}
+
+void IoUringPoller::cancel(int fd, const FdEntry& entry) {
+    io_uring_sqe* sqe = get_sqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = make_user_data(fd, entry);
+    sqe->user_data = kInternalUserData;
+}
+
+void IoUringPoller::rearm_pending() {
+    for (const auto& [fd, generation] : rearm_list_) {
+        FdEntry* entry = find_entry(fd);
+        if (entry != nullptr && entry->generation == generation) {
+            arm(fd, *entry);
+        }
+    }
+    rearm_list_.clear();
+}
+
+void IoUringPoller::reap(std::vector<PollEvent>& active_events) {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+        if (cqe.user_data == kInternalUserData) {
+            continue;
+        }
+
+        int fd = static_cast<int>(cqe.user_data & 0xffffffffu);
+        uint32_t generation = static_cast<uint32_t>(cqe.user_data >> 32) & kGenerationMask;
+        bool accept = cqe.user_data & kAcceptFlag;
+        bool more = cqe.flags & IORING_CQE_F_MORE;
+
+        FdEntry* entry = find_entry(fd);
+        if (entry == nullptr || entry->generation != generation) {
+            // 过期的 multishot accept 仍可能带回新连接，不能泄漏
+            if (accept && cqe.res >= 0) {
+                ::close(cqe.res);
+            }
+            continue;
+        }
+
+        if (!more) {
+            // oneshot 完成或 multishot 被内核终止，下一轮重新提交
+            rearm_list_.emplace_back(fd, generation);
+        }
+
+        if (cqe.res == -ECANCELED) {
+            continue;
+        }
+
+        FdHandler& handler = handlers_.get(fd);
+        if (entry->accept) {
+            if (cqe.res == -EAGAIN) {
+                continue;
+            }
+            active_events.push_back({cqe.res, EVENT_READ, &handler, handler.epoch(), true});
+        } else {
+            uint32_t revents = cqe.res < 0 ? EVENT_ERROR
+                                           : poll_to_events(static_cast<uint32_t>(cqe.res));
+            active_events.push_back({fd, revents, &handler, handler.epoch()});
+        }
+    }
+
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+}
+
+uint64_t IoUringPoller::make_user_data(int fd, const FdEntry& entry) {
+    uint64_t user_data = (static_cast<uint64_t>(entry.generation) << 32) | static_cast<uint32_t>(fd);
+    return entry.accept ? (user_data | kAcceptFlag) : user_data;
+}
+
+uint32_t IoUringPoller::events_to_poll(uint32_t events) const {
+    uint32_t poll_events = POLLERR | POLLHUP;
+
+    if (events & EVENT_READ) {
+        poll_events |= POLLIN | POLLPRI | POLLRDHUP;
+    }
+    if (events & EVENT_WRITE) {
+        poll_events |= POLLOUT;
+    }
+
+    return poll_events;
+}
+
+uint32_t IoUringPoller::poll_to_events(uint32_t poll_events) const {
+    uint32_t events = 0;
+
+    if (poll_events & (POLLIN | POLLPRI | POLLRDHUP)) {
+        events |= EVENT_READ;
+    }
+    if (poll_events & POLLOUT) {
+        events |= EVENT_WRITE;
+    }
+    if (poll_events & (POLLERR | POLLHUP)) {
+        events |= EVENT_ERROR;
+    }
+
+    return events;
+}
+
+}  // namespace tzzero::core
@@ -0,0 +1,41 @@
+#include "tzzero/core/loop_stats.h"
+#include <cstdio>
+
+namespace tzzero::core {
+
+void LoopStats::update_recent_utilization() {
+    double window = static_cast<double>(window_busy_ns_) / static_cast<double>(window_total_ns_);
+    double previous = recent_utilization_.load(std::memory_order_relaxed);
+    recent_utilization_.store(previous * 0.5 + window * 0.5, std::memory_order_relaxed);
+    window_busy_ns_ = 0;
+    window_total_ns_ = 0;
+}
+
+std::string LoopStats::summary() const {
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+             "conns=%lld iterations=%llu events=%llu util=%.1f%% "
+             "poll p50/p99=%.1f/%.1fus io p99=%.1fus timer p99=%.1fus functor p99=%.1fus "
+             "events/iter p50/p99=%llu/%llu queue p99/max=%llu/%zu "
+             "writes=%llu copied=%llu requests=%llu writes/req=%.2f",
+             static_cast<long long>(connections()),
+             static_cast<unsigned long long>(iterations()),
+             static_cast<unsigned long long>(events()),
+             utilization() * 100.0,
+             poll_time_.percentile(50) / 1000.0,
+             poll_time_.percentile(99) / 1000.0,
+             io_time_.percentile(99) / 1000.0,
+             timer_time_.percentile(99) / 1000.0,
+             functor_time_.percentile(99) / 1000.0,
+             static_cast<unsigned long long>(events_per_iteration_.percentile(50)),
+             static_cast<unsigned long long>(events_per_iteration_.percentile(99)),
+             static_cast<unsigned long long>(queue_depth_.percentile(99)),
+             max_queue_depth(),
+             static_cast<unsigned long long>(output_syscalls()),
+             static_cast<unsigned long long>(output_bytes_copied()),
+             static_cast<unsigned long long>(requests()),
+             writes_per_request());
+    return buf;
+}
+
+}  // namespace tzzero::core
@@ -6,6 +6,8 @@
 #endif
 
 #include <cstdlib>
+#include <iostream>
+#include <string>
 
 namespace tzzero::core {
 
@@ -22,8 +24,13 @@ std::unique_ptr<Poller> create_poller(EventLoop* loop) {
     if (poller_type && std::string(poller_type) == "epoll") {
         return std::make_unique<EpollPoller>(loop);
     }
-    // 默认使用 io_uring（如果可用）
-    return std::make_unique<IoUringPoller>(loop);
+    // 默认使用 io_uring，内核不支持时退回 epoll
+    try {
+        return std::make_unique<IoUringPoller>(loop);
+    } catch (const std::exception& e) {
+        std::cerr << "io_uring unavailable (" << e.what() << "), falling back to epoll" << std::endl;
+        return std::make_unique<EpollPoller>(loop);
+    }
 #else
     return std::make_unique<EpollPoller>(loop);
 #endif
@@ -0,0 +1,16 @@
+#include "tzzero/core/task.h"
+#include "tzzero/utils/logger.h"
+
+namespace tzzero::core {
+
+Detached spawn(Task<void> task) {
+    try {
+        co_await task;
+    } catch (const std::exception& e) {
+        LOG_ERROR("spawned task threw: " << e.what());
+    } catch (...) {
+        LOG_ERROR("spawned task threw an unknown exception");
+    }
+}
+
+}  // namespace tzzero::core
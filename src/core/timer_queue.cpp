@@ -1,213 +1,366 @@
 #include "tzzero/core/timer_queue.h"
 #include "tzzero/core/event_loop.h"
-#include "tzzero/core/poller.h"
-#include <sys/timerfd.h>
-#include <unistd.h>
 #include <cstring>
 #include <algorithm>
 
 namespace tzzero::core {
 
 namespace {
-int create_timerfd() {
-    int timerfd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
-    if (timerfd < 0) {
-        throw std::runtime_error("Failed to create timer fd");
-    }
-    return timerfd;
-}
 
-double now() {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec + ts.tv_nsec / 1000000000.0;
-}
+// 内部ID: [62:32] 代数 | [31:0] 节点下标；跨线程ID 置最高位
+constexpr uint64_t kRemoteFlag = 1ull << 63;
+constexpr uint32_t kGenerationMask = 0x7fffffffu;
 
-void read_timerfd(int timerfd) {
-    uint64_t howmany;
-    ssize_t n = ::read(timerfd, &howmany, sizeof(howmany));
-    // 注意：应该检查读取是否成功，但暂时忽略
-    (void)n;
+int64_t seconds_to_ns(double seconds) {
+    if (seconds <= 0.0) {
+        return 0;
+    }
+    return static_cast<int64_t>(seconds * 1000000000.0);
 }
 
-void reset_timerfd(int timerfd, double expiration) {
-    struct itimerspec new_value;
-    memset(&new_value, 0, sizeof(new_value));
-    
-    int64_t microseconds = static_cast<int64_t>(expiration * 1000000.0);
-    new_value.it_value.tv_sec = static_cast<time_t>(microseconds / 1000000);
-    new_value.it_value.tv_nsec = static_cast<long>((microseconds % 1000000) * 1000);
-    
-    int ret = ::timerfd_settime(timerfd, 0, &new_value, nullptr);
-    if (ret) {
-        // 注意：应该处理错误，但先让它能跑
+// 向上取整，保证定时器不会提前触发
+uint64_t ns_to_tick(int64_t ns) {
+    if (ns <= 0) {
+        return 0;
     }
+    return static_cast<uint64_t>((ns + TimerQueue::kTickNs - 1) / TimerQueue::kTickNs);
 }
 
 }  // anonymous namespace
 
-std::atomic<uint64_t> Timer::s_num_created_{0};
-
-Timer::Timer(double when, double interval, TimerCallback cb)
-    : callback_(std::move(cb))
-    , expiration_(when)
-    , interval_(interval)
-    , repeat_(interval > 0.0)
-    , sequence_(++s_num_created_)
+TimerQueue::TimerQueue(EventLoop* loop)
+    : loop_(loop)
+    , free_head_(kNil)
+    , capacity_(0)
+    , size_(0)
+    , now_ns_(utils::CachedClock::read_monotonic_ns())
+    , next_generation_(1)
+    , next_remote_id_(1)
 {
-}
+    memset(occupied_, 0, sizeof(occupied_));
+    current_tick_ = static_cast<uint64_t>(now_ns_ / kTickNs);
 
-void Timer::restart(double now) {
-    if (repeat_) {
-        expiration_ = now + interval_;
-    } else {
-        expiration_ = 0.0;
+    // 前 kLevels * kSlots 个节点是各槽的哨兵，随后一个是到期链表的哨兵
+    const uint32_t num_sentinels = kLevels * kSlots + 1;
+    for (uint32_t i = 0; i < num_sentinels; ++i) {
+        uint32_t index = allocate_node();
+        TimerNode& n = node(index);
+        n.prev = n.next = index;
     }
+    expired_ = num_sentinels - 1;
 }
 
-TimerQueue::TimerQueue(EventLoop* loop)
-    : loop_(loop)
-    , timer_fd_(create_timerfd())
-    , calling_expired_timers_(false)
-{
-    // 将定时器文件描述符添加到轮询器
-    loop_->get_poller()->add_fd(timer_fd_, Poller::EVENT_READ, [this](int, uint32_t) {
-        handle_timer_fd();
-    });
-}
+TimerQueue::~TimerQueue() = default;
+
+uint64_t TimerQueue::add_timer(double delay, double interval, TimerCallback cb) {
+    int64_t interval_ns = seconds_to_ns(interval);
 
-TimerQueue::~TimerQueue() {
-    loop_->get_poller()->remove_fd(timer_fd_);
-    ::close(timer_fd_);
-    
-    // 简单清理 - 可能有内存泄漏，后面再修复
-    for (const auto& timer_pair : timers_) {
-        delete timer_pair.second;
+    if (loop_->is_in_loop_thread()) {
+        // 循环运行中使用本轮缓存的时间，不再读时钟；循环开始前缓存可能已过时
+        int64_t now = loop_->looping() ? loop_->clock().monotonic_ns()
+                                       : utils::CachedClock::read_monotonic_ns();
+        int64_t expiration = now + seconds_to_ns(delay);
+        return add_timer_in_loop(expiration, interval_ns, std::move(cb));
     }
-}
 
-uint64_t TimerQueue::add_timer(double when, double interval, TimerCallback cb) {
-    auto timer = std::make_unique<Timer>(now() + when, interval, std::move(cb));
-    uint64_t seq = timer->sequence();
-    
-    // 简化版本 - 直接在当前线程添加，不考虑线程安全
-    add_timer_in_loop(std::move(timer));
-    
-    return seq;
+    int64_t expiration = utils::CachedClock::read_monotonic_ns() + seconds_to_ns(delay);
+
+    // 其他线程：先分配对外ID，再转交循环线程真正插入
+    uint64_t remote_id = kRemoteFlag | next_remote_id_.fetch_add(1, std::memory_order_relaxed);
+    loop_->queue_in_loop([this, remote_id, expiration, interval_ns, cb = std::move(cb)]() mutable {
+        uint64_t id = add_timer_in_loop(expiration, interval_ns, std::move(cb));
+        node(static_cast<uint32_t>(id)).remote_id = remote_id;
+        remote_ids_[remote_id] = id;
+    });
+    return remote_id;
 }
 
 void TimerQueue::cancel_timer(uint64_t timer_id) {
-    // 简化实现 - 后面再优化
-    cancel_in_loop(timer_id);
+    if (loop_->is_in_loop_thread()) {
+        cancel_in_loop(timer_id);
+    } else {
+        loop_->queue_in_loop([this, timer_id]() {
+            cancel_in_loop(timer_id);
+        });
+    }
 }
 
 int TimerQueue::get_next_timeout() const {
-    if (timers_.empty()) {
+    if (size_ == 0) {
         return -1;
     }
-    
-    double next_expire = timers_.begin()->first;
-    double now_time = now();
-    
-    if (next_expire <= now_time) {
+
+    // 最近需要处理的 tick：第 0 层最早的非空槽（可能已绕到下一圈），
+    // 与各高层下一个非空槽的级联边界，取较早者
+    uint64_t next_tick = UINT64_MAX;
+    uint32_t index = static_cast<uint32_t>(current_tick_ & kSlotMask);
+    uint32_t offset = find_next_slot(0, index, true);
+    if (offset < kSlots) {
+        next_tick = current_tick_ + offset;
+    }
+
+    for (int level = 1; level < kLevels; ++level) {
+        uint64_t level_tick = current_tick_ >> (kSlotBits * level);
+        uint32_t level_index = static_cast<uint32_t>(level_tick & kSlotMask);
+        uint32_t level_offset = find_next_slot(level, (level_index + 1) & kSlotMask, true);
+        if (level_offset < kSlots) {
+            uint64_t boundary = (level_tick + 1 + level_offset) << (kSlotBits * level);
+            next_tick = std::min(next_tick, boundary);
+        }
+    }
+
+    if (next_tick == UINT64_MAX) {
+        return -1;
+    }
+
+    int64_t delta_ns = static_cast<int64_t>(next_tick) * kTickNs - now_ns_;
+    if (delta_ns <= 0) {
         return 0;
     }
-    
-    return static_cast<int>((next_expire - now_time) * 1000);
+    int64_t timeout_ms = (delta_ns + 999999) / 1000000;
+    return static_cast<int>(std::min<int64_t>(timeout_ms, INT32_MAX));
 }
 
-void TimerQueue::process_expired_timers() {
-    calling_expired_timers_ = true;
-    
-    double now_time = now();
-    std::vector<Entry> expired = get_expired(now_time);
-    
-    // 简单执行，不处理异常情况
-    for (const auto& entry : expired) {
-        entry.second->run();
+void TimerQueue::process_expired_timers(int64_t now_ns) {
+    now_ns_ = now_ns;
+    uint64_t now_tick = static_cast<uint64_t>(now_ns_ / kTickNs);
+
+    if (size_ == 0) {
+        // 没有定时器时直接跳到当前时间
+        current_tick_ = std::max(current_tick_, now_tick + 1);
+        return;
+    }
+
+    while (current_tick_ <= now_tick) {
+        uint32_t index = static_cast<uint32_t>(current_tick_ & kSlotMask);
+        if (index == 0) {
+            cascade(current_tick_);
+        }
+
+        uint32_t offset = find_next_slot(0, index, false);
+        if (offset == kSlots) {
+            // 本轮剩余的槽都为空，直接跳到下一个级联边界
+            uint64_t boundary = (current_tick_ | kSlotMask) + 1;
+            if (boundary > now_tick) {
+                current_tick_ = now_tick + 1;
+                break;
+            }
+            current_tick_ = boundary;
+            continue;
+        }
+
+        uint64_t tick = current_tick_ + offset;
+        if (tick > now_tick) {
+            current_tick_ = now_tick + 1;
+            break;
+        }
+
+        // 先推进 current_tick_，回调中新加的已到期定时器会落到下一个 tick
+        current_tick_ = tick + 1;
+        expire_slot(static_cast<uint16_t>(index + offset));
+        run_expired();
     }
-    
-    reset(expired, now_time);
-    calling_expired_timers_ = false;
 }
 
-void TimerQueue::add_timer_in_loop(TimerPtr timer) {
-    bool earliest_changed = insert(timer.get());
-    
-    if (earliest_changed && !timers_.empty()) {
-        reset_timerfd(timer_fd_, timer->when());
+uint64_t TimerQueue::add_timer_in_loop(int64_t expiration, int64_t interval, TimerCallback cb) {
+    uint32_t index = allocate_node();
+    TimerNode& n = node(index);
+    n.callback = std::move(cb);
+    n.expiration = expiration;
+    n.interval = interval;
+    n.remote_id = 0;
+    n.generation = next_generation_;
+    n.state = NodeState::ACTIVE;
+
+    next_generation_ = (next_generation_ + 1) & kGenerationMask;
+    if (next_generation_ == 0) {
+        next_generation_ = 1;
     }
-    
-    timer.release(); // 转移所有权
+
+    place(index);
+    ++size_;
+    return (static_cast<uint64_t>(n.generation) << 32) | index;
 }
 
 void TimerQueue::cancel_in_loop(uint64_t timer_id) {
-    // 简化版本 - 线性搜索，效率不高
-    auto it = active_timers_.begin();
-    while (it != active_timers_.end()) {
-        if (it->second == timer_id) {
-            Timer* timer = it->first;
-            active_timers_.erase(it);
-            timers_.erase({timer->when(), timer});
-            delete timer;
-            break;
+    if (timer_id & kRemoteFlag) {
+        auto it = remote_ids_.find(timer_id);
+        if (it == remote_ids_.end()) {
+            return;
+        }
+        timer_id = it->second;
+        remote_ids_.erase(it);
+    }
+
+    uint32_t index = static_cast<uint32_t>(timer_id);
+    uint32_t generation = static_cast<uint32_t>(timer_id >> 32);
+    if (index >= capacity_ || index <= expired_) {
+        return;
+    }
+
+    TimerNode& n = node(index);
+    if (n.generation != generation) {
+        return;
+    }
+
+    if (n.state == NodeState::ACTIVE) {
+        unlink(index);
+        free_node(index);
+        --size_;
+    } else if (n.state == NodeState::RUNNING) {
+        // 回调执行完后由 run_expired 释放
+        n.state = NodeState::CANCELED;
+    }
+}
+
+uint32_t TimerQueue::allocate_node() {
+    if (free_head_ == kNil) {
+        chunks_.push_back(std::make_unique<TimerNode[]>(kChunkSize));
+        uint32_t base = capacity_;
+        capacity_ += kChunkSize;
+        // 倒序串入空闲链表，使低地址先被使用
+        for (uint32_t i = kChunkSize; i > 0; --i) {
+            TimerNode& n = node(base + i - 1);
+            n.next = free_head_;
+            free_head_ = base + i - 1;
         }
-        ++it;
     }
+
+    uint32_t index = free_head_;
+    free_head_ = node(index).next;
+    node(index).next = kNil;
+    return index;
 }
 
-void TimerQueue::handle_timer_fd() {
-    read_timerfd(timer_fd_);
-    process_expired_timers();
+void TimerQueue::free_node(uint32_t index) {
+    TimerNode& n = node(index);
+    n.callback = nullptr;
+    n.state = NodeState::FREE;
+    n.slot = kNoSlot;
+    n.prev = kNil;
+    n.generation = 0;
+    n.next = free_head_;
+    free_head_ = index;
 }
 
-std::vector<TimerQueue::Entry> TimerQueue::get_expired(double now_time) {
-    std::vector<Entry> expired;
-    Entry sentry(now_time, reinterpret_cast<Timer*>(UINTPTR_MAX));
-    auto end = timers_.lower_bound(sentry);
-    
-    std::copy(timers_.begin(), end, std::back_inserter(expired));
-    timers_.erase(timers_.begin(), end);
-    
-    // 从 active_timers_ 中移除
-    for (const auto& entry : expired) {
-        ActiveTimer timer(entry.second, entry.second->sequence());
-        active_timers_.erase(timer);
+void TimerQueue::link(uint32_t index, uint16_t slot) {
+    uint32_t head = sentinel(slot);
+    TimerNode& n = node(index);
+    TimerNode& h = node(head);
+
+    n.slot = slot;
+    n.prev = h.prev;
+    n.next = head;
+    node(h.prev).next = index;
+    h.prev = index;
+
+    if (slot < kLevels * kSlots) {
+        occupied_[slot / kSlots][(slot % kSlots) / 64] |= 1ull << (slot % 64);
     }
-    
-    return expired;
 }
 
-void TimerQueue::reset(const std::vector<Entry>& expired, double now_time) {
-    for (const auto& entry : expired) {
-        if (entry.second->repeat()) {
-            entry.second->restart(now_time);
-            insert(entry.second);
-        } else {
-            delete entry.second;
+void TimerQueue::unlink(uint32_t index) {
+    TimerNode& n = node(index);
+    node(n.prev).next = n.next;
+    node(n.next).prev = n.prev;
+
+    uint16_t slot = n.slot;
+    if (slot < kLevels * kSlots) {
+        const TimerNode& h = node(sentinel(slot));
+        if (h.next == sentinel(slot)) {
+            occupied_[slot / kSlots][(slot % kSlots) / 64] &= ~(1ull << (slot % 64));
         }
     }
-    
-    if (!timers_.empty()) {
-        double next_expire = timers_.begin()->second->when();
-        reset_timerfd(timer_fd_, next_expire);
+
+    n.prev = n.next = kNil;
+    n.slot = kNoSlot;
+}
+
+void TimerQueue::place(uint32_t index) {
+    TimerNode& n = node(index);
+    uint64_t tick = std::max(ns_to_tick(n.expiration), current_tick_);
+    uint64_t delta = tick - current_tick_;
+
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (1ull << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+    if (delta >= (1ull << (kSlotBits * kLevels))) {
+        // 超出时间轮范围，放在顶层最远的槽，级联时重新计算
+        tick = current_tick_ + (1ull << (kSlotBits * kLevels)) - 1;
     }
+
+    uint32_t slot_index = static_cast<uint32_t>((tick >> (kSlotBits * level)) & kSlotMask);
+    link(index, static_cast<uint16_t>(level * kSlots + slot_index));
 }
 
-bool TimerQueue::insert(Timer* timer) {
-    bool earliest_changed = false;
-    double when = timer->when();
-    auto it = timers_.begin();
-    
-    if (it == timers_.end() || when < it->first) {
-        earliest_changed = true;
+void TimerQueue::cascade(uint64_t tick) {
+    // 第 L 层当前槽中的定时器都落在接下来的 256^L 个 tick 内，重新放置到低层
+    for (int level = 1; level < kLevels; ++level) {
+        uint32_t slot_index = static_cast<uint32_t>((tick >> (kSlotBits * level)) & kSlotMask);
+        uint16_t slot = static_cast<uint16_t>(level * kSlots + slot_index);
+        uint32_t head = sentinel(slot);
+
+        while (node(head).next != head) {
+            uint32_t index = node(head).next;
+            unlink(index);
+            place(index);
+        }
+
+        if (slot_index != 0) {
+            break;
+        }
     }
-    
-    timers_.insert({when, timer});
-    active_timers_.insert({timer, timer->sequence()});
-    
-    return earliest_changed;
 }
 
-}  // namespace tzzero::core
+void TimerQueue::expire_slot(uint16_t slot) {
+    // 整个槽链表拼接到到期链表末尾
+    uint32_t head = sentinel(slot);
+    while (node(head).next != head) {
+        uint32_t index = node(head).next;
+        unlink(index);
+        link(index, static_cast<uint16_t>(kLevels * kSlots));
+    }
+}
+
+void TimerQueue::run_expired() {
+    while (node(expired_).next != expired_) {
+        uint32_t index = node(expired_).next;
+        unlink(index);
+
+        TimerNode& n = node(index);
+        n.state = NodeState::RUNNING;
+        // 节点地址稳定，回调中增删定时器不会使引用失效
+        n.callback();
+
+        if (n.state == NodeState::RUNNING && n.interval > 0) {
+            n.state = NodeState::ACTIVE;
+            n.expiration = now_ns_ + n.interval;
+            place(index);
+            continue;
+        }
 
+        if (n.remote_id != 0) {
+            remote_ids_.erase(n.remote_id);
+        }
+        free_node(index);
+        --size_;
+    }
+}
+
+uint32_t TimerQueue::find_next_slot(int level, uint32_t from, bool wrap) const {
+    uint32_t limit = wrap ? kSlots : kSlots - from;
+
+    for (uint32_t offset = 0; offset < limit;) {
+        uint32_t slot = (from + offset) & kSlotMask;
+        uint64_t bits = occupied_[level][slot / 64] >> (slot % 64);
+        if (bits) {
+            uint32_t found = offset + static_cast<uint32_t>(__builtin_ctzll(bits));
+            return found < limit ? found : kSlots;
+        }
+        offset += 64 - (slot % 64);
+    }
+    return kSlots;
+}
+
+}  // namespace tzzero::core
@@ -1,7 +1,13 @@
 #include "tzzero/http/http_response.h"
+#include "tzzero/utils/cached_clock.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
 #include <algorithm>
 #include <sstream>
-#include <ctime>
 #include <iomanip>
 
 namespace tzzero::http {
@@ -77,19 +83,44 @@ void HttpResponse::remove_header(const std::string& field) {
 
 void HttpResponse::set_body(const std::string& body) {
     body_ = body;
+    file_.reset();
     ensure_content_length();
 }
 
 void HttpResponse::set_body(std::string&& body) {
     body_ = std::move(body);
+    file_.reset();
     ensure_content_length();
 }
 
 void HttpResponse::append_body(const std::string& data) {
     body_ += data;
+    file_.reset();
     ensure_content_length();
 }
 
+void HttpResponse::set_file_body(int fd, off_t offset, size_t length) {
+    file_ = std::make_shared<const net::OpenFile>(fd);
+    file_offset_ = offset;
+    file_length_ = length;
+    body_.clear();
+    set_header("content-length", std::to_string(length));
+}
+
+bool HttpResponse::set_file_body(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+    set_file_body(fd, 0, static_cast<size_t>(st.st_size));
+    return true;
+}
+
 void HttpResponse::set_content_type(const std::string& content_type) {
     set_header("content-type", content_type);
 }
@@ -106,6 +137,7 @@ void HttpResponse::reset() {
     close_connection_ = false;
     headers_.clear();
     body_.clear();
+    file_.reset();
     stream_id_ = 0;
 }
 
@@ -116,6 +148,52 @@ std::string HttpResponse::to_buffer() const {
 }
 
 void HttpResponse::append_to_buffer(std::string& buffer) const {
+    size_t original = buffer.size();
+    append_head_to_buffer(buffer);
+
+    // Body
+    if (!body_.empty()) {
+        buffer += body_;
+    }
+
+    // A file body has no socket to sendfile into here, so read the region
+    if (file_) {
+        size_t start = buffer.size();
+        buffer.resize(start + file_length_);
+        size_t done = 0;
+        while (done < file_length_) {
+            ssize_t n = ::pread(file_->fd(), &buffer[start + done], file_length_ - done,
+                                file_offset_ + static_cast<off_t>(done));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                // content-length is already in the head; a short body would
+                // misframe the connection, so fail instead
+                int err = n < 0 ? errno : EIO;
+                buffer.resize(original);
+                throw std::runtime_error("HttpResponse: failed to read file body: " +
+                                         std::string(strerror(err)));
+            }
+            done += static_cast<size_t>(n);
+        }
+    }
+}
+
+void HttpResponse::move_to_queue(net::OutputQueue& queue) {
+    std::string head;
+    append_head_to_buffer(head);
+    queue.append(std::move(head));
+    if (file_) {
+        queue.append_file(std::move(file_), file_offset_, file_length_);
+        file_.reset();
+    } else {
+        queue.append(std::move(body_));
+        body_.clear();
+    }
+}
+
+void HttpResponse::append_head_to_buffer(std::string& buffer) const {
     // Status line
     buffer += "HTTP/1.1 ";
     buffer += std::to_string(static_cast<int>(status_code_));
@@ -145,21 +223,13 @@ void HttpResponse::append_to_buffer(std::string& buffer) const {
     
     // Date header
     if (!has_header("date")) {
-        auto now = std::time(nullptr);
-        auto tm = *::gmtime(&now);
-        char date_buf[100];
-        ::strftime(date_buf, sizeof(date_buf), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+        // Pre-rendered once per second by the loop's cached clock
         buffer += "date: ";
-        buffer += date_buf;
+        buffer += utils::CachedClock::current().http_date();
         buffer += "\r\n";
     }
     
     buffer += "\r\n";
-    
-    // Body
-    if (!body_.empty()) {
-        buffer += body_;
-    }
 }
 
 void HttpResponse::ensure_content_length() {
@@ -1,11 +1,36 @@
 #include "tzzero/http/http_server.h"
 #include "tzzero/http/http_parser.h"
 #include "tzzero/core/event_loop.h"
+#include "tzzero/core/awaitables.h"
+#include "tzzero/core/frame_pool.h"
 #include "tzzero/utils/logger.h"
+#include <deque>
 #include <unordered_map>
 
 namespace tzzero::http {
 
+namespace {
+
+// 等待按序发出的响应；数据为空且要求关闭的是解析错误后的关闭标记
+struct PendingResponse {
+    net::OutputQueue data;                  // 头部和正文分段，不拼接
+    bool close_connection{false};
+    bool ready{false};
+};
+
+}  // anonymous namespace
+
+// 每个连接的解析和流水线状态，只在连接所属的I/O线程中访问
+struct HttpServer::ConnectionState {
+    HttpParser parser;
+    HttpRequest request;                    // 正在解析的请求
+    std::deque<PendingResponse, core::PoolAllocator<PendingResponse>> pending;  // 按请求顺序排列，队首完成后才能发出
+    bool draining{false};                   // 不再解析新请求
+    bool closed{false};                     // 已发出关闭连接的响应
+    bool backlogged{false};                 // 等待发出的响应达到上限，暂停解析
+    bool resume_scheduled{false};           // 已安排下一轮继续解析缓冲中剩下的请求
+};
+
 HttpServer::HttpServer(core::EventLoop* loop, const std::string& listen_addr,
                        uint16_t port, const std::string& name)
     : loop_(loop)
@@ -23,6 +48,7 @@ HttpServer::HttpServer(core::EventLoop* loop, const std::string& listen_addr,
 HttpServer::~HttpServer() = default;
 
 void HttpServer::start() {
+    server_->set_idle_timeout(keep_alive_timeout_);
     server_->start();
 }
 
@@ -30,8 +56,12 @@ void HttpServer::stop() {
     server_->stop();
 }
 
-void HttpServer::set_thread_num(int num_threads) {
-    server_->set_thread_num(num_threads);
+void HttpServer::set_worker_threads(size_t num_threads) {
+    worker_pool_ = num_threads > 0 ? std::make_shared<utils::ThreadPool>(num_threads) : nullptr;
+}
+
+void HttpServer::set_thread_num(int num_threads, const net::ThreadAffinity& affinity) {
+    server_->set_thread_num(num_threads, affinity);
 }
 
 #ifdef ENABLE_TLS
@@ -44,14 +74,13 @@ void HttpServer::enable_tls(const std::string& cert_file, const std::string& key
 #endif
 
 void HttpServer::on_connection(const net::TcpConnectionPtr& conn) {
-    LOG_INFO("HttpServer - " << conn->get_local_address()
+    LOG_DEBUG("HttpServer - " << conn->get_local_address()
              << " -> " << conn->get_peer_address() << " is "
              << (conn->connected() ? "UP" : "DOWN"));
 
     if (conn->connected()) {
-        // 为此连接创建HTTP解析器
-        auto parser = std::make_shared<HttpParser>();
-        conn->set_context(parser);
+        // 为此连接创建解析状态，与连接一样从本线程的帧池分配
+        conn->set_context(std::allocate_shared<ConnectionState>(core::PoolAllocator<ConnectionState>()));
 
         // 设置TCP选项
         conn->set_tcp_no_delay(true);
@@ -60,42 +89,136 @@ void HttpServer::on_connection(const net::TcpConnectionPtr& conn) {
 }
 
 void HttpServer::on_message(const net::TcpConnectionPtr& conn, utils::Buffer& buffer) {
-    std::shared_ptr<HttpParser> parser;
-    try {
-        parser = std::any_cast<std::shared_ptr<HttpParser>>(conn->get_context());
-    } catch (const std::bad_any_cast&) {
-        // 上下文未设置或类型错误，创建新解析器
-        parser = std::make_shared<HttpParser>();
-        conn->set_context(parser);
-    }
-
-    HttpRequest request;
-    if (parser->parse_request(buffer, request)) {
-        // 收到完整请求
-        on_request(conn, request);
-
-        // 重置解析器用于下一个请求（Keep-Alive）
-        parser->reset();
-    } else if (parser->has_error()) {
-        // 解析错误，关闭连接
-        LOG_ERROR("HTTP parse error from " << conn->get_peer_address());
-        conn->shutdown();
+    // 借用上下文中的状态，不复制 shared_ptr
+    ConnectionStatePtr* slot = std::any_cast<ConnectionStatePtr>(&conn->get_mutable_context());
+    if (slot == nullptr) {
+        // 上下文未设置或类型错误，创建新状态
+        conn->set_context(std::allocate_shared<ConnectionState>(core::PoolAllocator<ConnectionState>()));
+        slot = std::any_cast<ConnectionStatePtr>(&conn->get_mutable_context());
+    }
+    const ConnectionStatePtr& state = *slot;
+
+    // 缓冲中可能有多个流水线请求，逐个解析；不完整的请求留在 state 中等待更多数据。
+    // 等待发出的响应达到上限时停止解析，剩下的请求留在缓冲中，由 flush_responses
+    // 在队列降到上限以下后安排继续：它们已经读进缓冲，不会再有可读事件提醒
+    while (!state->draining) {
+        if (max_pipelined_requests_ > 0 && state->pending.size() >= max_pipelined_requests_) {
+            state->backlogged = true;
+            break;
+        }
+        if (!state->parser.parse_request(buffer, state->request)) {
+            if (state->parser.has_error()) {
+                // 解析错误，发出之前请求的响应后关闭连接。它们可能还在工作线程或协程中，
+                // 排一个空的关闭标记，轮到它时由 flush_responses 关闭
+                LOG_ERROR("HTTP parse error from " << conn->get_peer_address());
+                state->draining = true;
+                state->pending.push_back(PendingResponse{net::OutputQueue(), true, true});
+            }
+            break;
+        }
+
+        HttpRequest request = std::move(state->request);
+        state->request = HttpRequest();
+        state->parser.reset();
+        on_request(conn, state, std::move(request));
+    }
+
+    // 这一批中同步完成的响应一起发出
+    flush_responses(conn, *state);
+}
+
+void HttpServer::resume_pipeline(const net::TcpConnectionPtr& conn) {
+    ConnectionStatePtr* slot = std::any_cast<ConnectionStatePtr>(&conn->get_mutable_context());
+    if (slot == nullptr) {
+        return;
+    }
+    (*slot)->resume_scheduled = false;
+    if (conn->connected()) {
+        on_message(conn, conn->get_input_buffer());
+    }
+}
+
+void HttpServer::on_request(const net::TcpConnectionPtr& conn, const ConnectionStatePtr& state,
+                            HttpRequest&& req) {
+    conn->get_loop()->request_handled();
+
+    if (!req.keep_alive() || !keep_alive_enabled_) {
+        // 这个响应之后连接关闭，不再解析后续请求
+        state->draining = true;
+    }
+
+    if (async_http_callback_) {
+        run_async_handler(conn, state, std::move(req));
+        return;
+    }
+
+    bool offload = worker_pool_ && (!offload_predicate_ || offload_predicate_(req));
+    if (!offload) {
+        bool close_connection = false;
+        net::OutputQueue data = handle_request(req, close_connection);
+        // 由 on_message 在这一批请求处理完后统一发出
+        state->pending.push_back(PendingResponse{std::move(data), close_connection, true});
         return;
     }
-    // 如果请求不完整，等待更多数据
+
+    // 先按请求顺序占位，工作线程完成后填入；deque 尾部追加不会使已有元素的引用失效
+    state->pending.push_back(PendingResponse{});
+    PendingResponse* slot = &state->pending.back();
+
+    utils::ThreadPool::Task task = [this, conn, state, slot, req = std::move(req)]() {
+        bool close_connection = false;
+        // 任务回调须可拷贝，队列放在共享对象里带回I/O线程
+        auto data = std::make_shared<net::OutputQueue>(handle_request(req, close_connection));
+        conn->get_loop()->run_in_loop(
+            [this, conn, state, slot, data, close_connection]() {
+                slot->data = std::move(*data);
+                slot->close_connection = close_connection;
+                slot->ready = true;
+                flush_responses(conn, *state);
+            });
+    };
+    if (!worker_pool_->try_post(std::move(task))) {
+        // 工作线程池已满，在I/O线程中直接执行
+        task();
+    }
 }
 
-void HttpServer::on_request(const net::TcpConnectionPtr& conn, const HttpRequest& req) {
+net::OutputQueue HttpServer::handle_request(const HttpRequest& req, bool& close_connection) const {
     HttpResponse response;
+    set_default_headers(req, response);
+
+    // 调用用户回调
+    if (http_callback_) {
+        try {
+            http_callback_(req, response);
+        } catch (const std::exception& e) {
+            LOG_ERROR("HttpServer - handler threw for " << req.get_path() << ": " << e.what());
+            response.set_status_code(HttpStatusCode::INTERNAL_SERVER_ERROR);
+            response.set_html_content_type();
+            response.set_body("<html><body><h1>500 Internal Server Error</h1></body></html>");
+        }
+    } else {
+        // 默认404响应
+        response.set_status_code(HttpStatusCode::NOT_FOUND);
+        response.set_html_content_type();
+        response.set_body("<html><body><h1>404 Not Found</h1></body></html>");
+    }
+
+    // 序列化头部，正文移入输出队列不再复制
+    net::OutputQueue response_data;
+    close_connection = response.close_connection();
+    response.move_to_queue(response_data);
+    return response_data;
+}
 
-    // 设置默认头部
+void HttpServer::set_default_headers(const HttpRequest& req, HttpResponse& response) const {
     response.set_header("Server", "TZZeroHTTP/1.0");
 
     // 处理Keep-Alive
-    bool close_connection = !req.keep_alive() || !keep_alive_enabled_;
-    response.set_close_connection(close_connection);
+    bool close = !req.keep_alive() || !keep_alive_enabled_;
+    response.set_close_connection(close);
 
-    if (close_connection) {
+    if (close) {
         response.set_header("Connection", "close");
     } else {
         response.set_header("Connection", "keep-alive");
@@ -103,25 +226,96 @@ void HttpServer::on_request(const net::TcpConnectionPtr& conn, const HttpRequest
             response.set_header("Keep-Alive", "timeout=" + std::to_string(keep_alive_timeout_));
         }
     }
+}
 
-    // 调用用户回调
-    if (http_callback_) {
-        http_callback_(req, response);
-    } else {
-        // 默认404响应
-        response.set_status_code(HttpStatusCode::NOT_FOUND);
+core::Detached HttpServer::run_async_handler(net::TcpConnectionPtr conn, ConnectionStatePtr state,
+                                             HttpRequest req) {
+    // 启动时同步执行到这里，占位顺序与请求顺序一致
+    state->pending.push_back(PendingResponse{});
+    PendingResponse* slot = &state->pending.back();
+    core::EventLoop* loop = conn->get_loop();
+
+    HttpResponse response;
+    bool failed = false;
+    try {
+        response = co_await async_http_callback_(req);
+    } catch (const std::exception& e) {
+        LOG_ERROR("HttpServer - async handler threw for " << req.get_path() << ": " << e.what());
+        failed = true;
+    }
+    if (failed) {
+        response = HttpResponse();
+        response.set_status_code(HttpStatusCode::INTERNAL_SERVER_ERROR);
         response.set_html_content_type();
-        response.set_body("<html><body><h1>404 Not Found</h1></body></html>");
+        response.set_body("<html><body><h1>500 Internal Server Error</h1></body></html>");
     }
 
-    // 发送响应
-    std::string response_data;
-    response.append_to_buffer(response_data);
-    conn->send(response_data);
+    // 处理器未设置的默认头部补上；处理器要求关闭时以关闭为准
+    HttpResponse defaults;
+    set_default_headers(req, defaults);
+    bool close_connection = defaults.close_connection() || response.close_connection();
+    for (const auto& [field, value] : defaults.get_headers()) {
+        if (!response.has_header(field)) {
+            response.set_header(field, value);
+        }
+    }
+    if (close_connection) {
+        response.set_header("Connection", "close");
+        response.remove_header("Keep-Alive");
+    }
+    response.set_close_connection(close_connection);
+
+    net::OutputQueue data;
+    response.move_to_queue(data);
 
-    if (response.close_connection()) {
+    // 处理器可能跳到了其他线程
+    co_await core::resume_on(loop);
+    slot->data = std::move(data);
+    slot->close_connection = close_connection;
+    slot->ready = true;
+    flush_responses(conn, *state);
+}
+
+void HttpServer::flush_responses(const net::TcpConnectionPtr& conn, ConnectionState& state) {
+    // 连续已完成的响应按序并入一个队列，连接一次写出
+    net::OutputQueue batch;
+    bool close_connection = false;
+    while (!state.pending.empty() && state.pending.front().ready) {
+        PendingResponse& front = state.pending.front();
+        if (!state.closed) {
+            batch.append(std::move(front.data));
+            if (front.close_connection) {
+                close_connection = true;
+                state.closed = true;
+                state.draining = true;
+            }
+        }
+        state.pending.pop_front();
+    }
+    if (!batch.empty()) {
+        conn->send(std::move(batch));
+    }
+    if (close_connection) {
         conn->shutdown();
     }
+
+    // 队列降到上限以下，下一轮继续解析缓冲中剩下的请求，同一批同步请求的响应仍合并写出
+    if (state.backlogged && state.pending.size() < max_pipelined_requests_) {
+        state.backlogged = false;
+        if (!state.draining && !state.resume_scheduled && conn->get_input_buffer().readable_bytes() > 0) {
+            state.resume_scheduled = true;
+            conn->get_loop()->queue_in_loop([this, conn]() {
+                resume_pipeline(conn);
+            });
+        }
+    }
+
+    // 还有处理器没完成时连接不算空闲，慢处理器不会被 Keep-Alive 超时中途关闭
+    if (state.pending.empty()) {
+        conn->resume_idle_timeout();
+    } else {
+        conn->pause_idle_timeout();
+    }
 }
 
 } // namespace tzzero::http
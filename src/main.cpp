@@ -3,6 +3,7 @@
 #include "tzzero/http/http_request.h"
 #include "tzzero/http/http_response.h"
 #include "tzzero/utils/logger.h"
+#include "tzzero/utils/cpu_topology.h"
 #include <iostream>
 #include <csignal>
 #include <ctime>
@@ -42,6 +43,11 @@ void print_usage(const char* program_name) {
               << "  -p, --port PORT      监听端口 (默认: 3000)\n"
               << "  -a, --addr ADDR      监听地址 (默认: 0.0.0.0)\n"
               << "  -t, --threads NUM    工作线程数 (默认: CPU核心数)\n"
+              << "  -c, --cpus LIST      I/O 线程绑核: physical 或 CPU 列表如 0-3,8 (默认: 不绑定)\n"
+              << "  -n, --numa-local     I/O 线程内存优先本地 NUMA 节点\n"
+              << "  -b, --balance MODE   连接分配: rr, least, p2c, hash (默认: rr)\n"
+              << "  -r, --reuseport     每个 I/O 线程各自监听并 accept (SO_REUSEPORT)\n"
+              << "      --cpu-steering   配合 --reuseport，按收包 CPU 选择监听套接字\n"
               << "  -k, --keepalive      启用HTTP keep-alive (默认: 启用)\n"
               << "  -l, --log-file FILE  日志输出文件 (默认: 仅控制台)\n"
               << "  -L, --log-level LVL  日志级别: DEBUG, INFO, WARN, ERROR (默认: INFO)\n"
@@ -138,6 +144,11 @@ int main(int argc, char* argv[]) {
     bool verbose = false;
     std::string log_file;
     std::string log_level = "INFO";
+    std::string cpus;
+    bool numa_local = false;
+    bool reuse_port = false;
+    std::string balance = "rr";
+    bool cpu_steering = false;
 
     // 命令行参数解析
     struct option long_options[] = {
@@ -145,6 +156,11 @@ int main(int argc, char* argv[]) {
         {"port", required_argument, 0, 'p'},
         {"addr", required_argument, 0, 'a'},
         {"threads", required_argument, 0, 't'},
+        {"cpus", required_argument, 0, 'c'},
+        {"numa-local", no_argument, 0, 'n'},
+        {"balance", required_argument, 0, 'b'},
+        {"reuseport", no_argument, 0, 'r'},
+        {"cpu-steering", no_argument, 0, 'S'},
         {"keepalive", no_argument, 0, 'k'},
         {"log-file", required_argument, 0, 'l'},
         {"log-level", required_argument, 0, 'L'},
@@ -153,7 +169,7 @@ int main(int argc, char* argv[]) {
     };
 
     int c;
-    while ((c = getopt_long(argc, argv, "hp:a:t:kl:L:v", long_options, nullptr)) != -1) {
+    while ((c = getopt_long(argc, argv, "hp:a:t:c:nb:rkl:L:v", long_options, nullptr)) != -1) {
         switch (c) {
             case 'h':
                 print_usage(argv[0]);
@@ -167,6 +183,21 @@ int main(int argc, char* argv[]) {
             case 't':
                 thread_num = std::stoi(optarg);
                 break;
+            case 'c':
+                cpus = optarg;
+                break;
+            case 'n':
+                numa_local = true;
+                break;
+            case 'b':
+                balance = optarg;
+                break;
+            case 'r':
+                reuse_port = true;
+                break;
+            case 'S':
+                cpu_steering = true;
+                break;
             case 'k':
                 enable_keepalive = true;
                 break;
@@ -220,7 +251,22 @@ int main(int argc, char* argv[]) {
         g_server = &server;
 
         // 配置服务器
-        server.set_thread_num(thread_num);
+        tzzero::net::ThreadAffinity affinity;
+        if (cpus == "physical") {
+            affinity = tzzero::net::ThreadAffinity::physical_cores(numa_local);
+        } else if (!cpus.empty()) {
+            affinity = tzzero::net::ThreadAffinity::core_list(
+                CpuTopology::parse_cpu_list(cpus), numa_local);
+        }
+        server.set_thread_num(thread_num, affinity);
+        if (balance == "least") server.set_load_balance(tzzero::net::LoadBalance::LEAST_CONNECTIONS);
+        else if (balance == "p2c") server.set_load_balance(tzzero::net::LoadBalance::POWER_OF_TWO);
+        else if (balance == "hash") server.set_load_balance(tzzero::net::LoadBalance::PEER_HASH);
+        else if (balance != "rr") {
+            std::cerr << "无效的连接分配策略: " << balance << std::endl;
+            return 1;
+        }
+        server.set_accept_per_loop(reuse_port, cpu_steering);
         server.enable_keep_alive(enable_keepalive);
         server.set_keep_alive_timeout(60);
 
@@ -2,6 +2,7 @@
 #include "tzzero/core/event_loop.h"
 #include "tzzero/core/poller.h"
 #include <sys/socket.h>
+#include <linux/filter.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -16,6 +17,7 @@ Acceptor::Acceptor(core::EventLoop* loop, const std::string& listen_addr, uint16
     : loop_(loop)
     , accept_fd_(create_nonblocking_socket())
     , idle_fd_(::open("/dev/null", O_RDONLY | O_CLOEXEC))
+    , bound_(false)
     , listening_(false)
     , listen_addr_(listen_addr)
     , port_(port)
@@ -31,17 +33,31 @@ Acceptor::~Acceptor() {
     }
 }
 
+void Acceptor::bind() {
+    if (bound_) {
+        return;
+    }
+    bind_and_listen();
+    bound_ = true;
+}
+
 void Acceptor::listen() {
     if (listening_) {
         return;
     }
 
-    bind_and_listen();
-
-    // 添加到事件循环并设置回调
-    loop_->get_poller()->add_fd(accept_fd_,
-                               core::Poller::EVENT_READ,
-                               [this](int, uint32_t) { handle_read(); });
+    bind();
+
+    // 轮询器支持时由其直接完成 accept（io_uring multishot accept），
+    // 否则注册可读事件并在回调中 accept4
+    core::Poller* poller = loop_->get_poller();
+    bool direct_accept = poller->add_accept_fd(accept_fd_,
+                                               [this](int conn_fd) { handle_accepted(conn_fd); });
+    if (!direct_accept) {
+        poller->add_fd(accept_fd_,
+                       core::Poller::EVENT_READ,
+                       [this](int, uint32_t) { handle_read(); });
+    }
     listening_ = true;
 }
 
@@ -55,48 +71,103 @@ void Acceptor::disable_listening() {
     listening_ = false;
 }
 
+bool Acceptor::attach_cpu_steering(size_t group_size) {
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    if (!bound_ || group_size == 0) {
+        return false;
+    }
+    // A = 当前 CPU; A %= group_size; return A
+    struct sock_filter code[] = {
+        { BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU) },
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t>(group_size) },
+        { BPF_RET | BPF_A, 0, 0, 0 },
+    };
+    struct sock_fprog prog;
+    prog.len = sizeof(code) / sizeof(code[0]);
+    prog.filter = code;
+    if (::setsockopt(accept_fd_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) < 0) {
+        std::cerr << "Warning: SO_ATTACH_REUSEPORT_CBPF failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+#else
+    (void)group_size;
+    return false;
+#endif
+}
+
 void Acceptor::handle_read() {
-    struct sockaddr_in peer_addr;
-    socklen_t addr_len = sizeof(peer_addr);
+    AcceptedSocket accepted;
 
     // 限制每次循环的接受数量以防止饥饿
     for (int i = 0; i < kMaxAcceptPerLoop; ++i) {
-        int conn_fd = ::accept4(accept_fd_, 
-                               reinterpret_cast<struct sockaddr*>(&peer_addr),
-                               &addr_len,
-                               SOCK_NONBLOCK | SOCK_CLOEXEC);
-        
-        if (conn_fd >= 0) {
-            // 获得新连接
-            std::string peer_ip = ::inet_ntoa(peer_addr.sin_addr);
-            uint16_t peer_port = ntohs(peer_addr.sin_port);
-            std::string peer_address = peer_ip + ":" + std::to_string(peer_port);
-            
-            if (new_connection_callback_) {
-                new_connection_callback_(conn_fd, peer_address);
-            } else {
-                ::close(conn_fd);
-            }
+        *accepted.peer.length() = accepted.peer.capacity();
+        accepted.fd = ::accept4(accept_fd_, accepted.peer.data(), accepted.peer.length(),
+                                SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (accepted.fd >= 0) {
+            // 获得新连接，地址保持原始形式，需要时再格式化
+            deliver(accepted);
         } else {
             int saved_errno = errno;
             if (saved_errno != EAGAIN && saved_errno != EWOULDBLOCK) {
-                if (saved_errno == EMFILE || saved_errno == ENFILE) {
-                    // 打开文件太多 - EMFILE 保护
-                    ::close(idle_fd_);  // 关闭保留的文件描述符
-                    conn_fd = ::accept(accept_fd_, nullptr, nullptr);
-                    if (conn_fd >= 0) {
-                        ::close(conn_fd);  // 立即关闭连接
-                    }
-                    idle_fd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);  // 重新打开保留的文件描述符
-                    std::cerr << "accept: " << strerror(saved_errno) << " - connection rejected" << std::endl;
-                } else {
-                    // 其他错误
-                    std::cerr << "accept error: " << strerror(saved_errno) << std::endl;
-                }
+                handle_accept_error(saved_errno);
             }
             break;
         }
     }
+
+    flush_batch();
+}
+
+void Acceptor::handle_accepted(int conn_fd) {
+    if (conn_fd < 0) {
+        handle_accept_error(-conn_fd);
+        return;
+    }
+
+    // multishot accept 不返回对端地址，留给连接按需查询
+    bool first = batch_.empty();
+    AcceptedSocket accepted{conn_fd, SocketAddress{}};
+    deliver(accepted);
+    if (new_connections_callback_ && first) {
+        // 每个完成单独分发，本轮循环末尾统一交付
+        loop_->queue_in_loop([this]() { flush_batch(); });
+    }
+}
+
+void Acceptor::deliver(AcceptedSocket& accepted) {
+    if (new_connections_callback_) {
+        batch_.push_back(accepted);
+    } else if (new_connection_callback_) {
+        new_connection_callback_(accepted);
+    } else {
+        ::close(accepted.fd);
+    }
+}
+
+void Acceptor::flush_batch() {
+    if (batch_.empty()) {
+        return;
+    }
+    new_connections_callback_(batch_);
+    batch_.clear();
+}
+
+void Acceptor::handle_accept_error(int saved_errno) {
+    if (saved_errno == EMFILE || saved_errno == ENFILE) {
+        // 打开文件太多 - EMFILE 保护
+        ::close(idle_fd_);  // 关闭保留的文件描述符
+        int conn_fd = ::accept(accept_fd_, nullptr, nullptr);
+        if (conn_fd >= 0) {
+            ::close(conn_fd);  // 立即关闭连接
+        }
+        idle_fd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);  // 重新打开保留的文件描述符
+        std::cerr << "accept: " << strerror(saved_errno) << " - connection rejected" << std::endl;
+    } else {
+        // 其他错误
+        std::cerr << "accept error: " << strerror(saved_errno) << std::endl;
+    }
 }
 
 int Acceptor::create_nonblocking_socket() {
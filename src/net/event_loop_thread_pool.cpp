@@ -1,13 +1,18 @@
 #include "tzzero/net/event_loop_thread_pool.h"
 #include "tzzero/core/event_loop.h"
+#include "tzzero/utils/cpu_topology.h"
+#include "tzzero/utils/logger.h"
+#include <algorithm>
 #include <cassert>
 
 namespace tzzero::net {
 
-EventLoopThread::EventLoopThread(const ThreadInitCallback& cb)
+EventLoopThread::EventLoopThread(const ThreadInitCallback& cb, int cpu, bool numa_local)
     : loop_(nullptr)
     , exiting_(false)
     , callback_(cb)
+    , cpu_(cpu)
+    , numa_local_(numa_local)
 {
 }
 
@@ -36,7 +41,18 @@ core::EventLoop* EventLoopThread::start_loop() {
 }
 
 void EventLoopThread::thread_func() {
+    // 先绑核再创建 EventLoop，循环自身的内存在本地节点首次触碰
+    if (cpu_ >= 0 && !utils::CpuTopology::pin_current_thread(cpu_)) {
+        LOG_WARN("EventLoopThread - failed to pin thread to cpu " << cpu_);
+    }
+    if (numa_local_ && !utils::CpuTopology::prefer_local_memory()) {
+        LOG_WARN("EventLoopThread - set_mempolicy(MPOL_LOCAL) failed");
+    }
+
     core::EventLoop loop;
+    if (cpu_ >= 0 && numa_local_) {
+        loop.set_numa_node(utils::CpuTopology::detect().numa_node_of(cpu_));
+    }
 
     if (callback_) {
         callback_(&loop);
@@ -59,6 +75,8 @@ EventLoopThreadPool::EventLoopThreadPool(core::EventLoop* base_loop)
     , started_(false)
     , num_threads_(0)
     , next_(0)
+    , strategy_(LoadBalance::ROUND_ROBIN)
+    , rng_state_(0x9e3779b97f4a7c15ULL)
 {
 }
 
@@ -72,33 +90,160 @@ void EventLoopThreadPool::start(const ThreadInitCallback& cb) {
 
     started_ = true;
 
+    std::vector<int> cpus = plan_cpus();
     for (int i = 0; i < num_threads_; ++i) {
-        auto thread = std::make_unique<EventLoopThread>(cb);
+        auto thread = std::make_unique<EventLoopThread>(cb, cpus[i], affinity_.numa_local);
         loops_.push_back(thread->start_loop());
         threads_.push_back(std::move(thread));
     }
+    dispatched_.assign(loops_.size(), 0);
 
     if (num_threads_ == 0 && cb) {
         cb(base_loop_);
     }
 }
 
-core::EventLoop* EventLoopThreadPool::get_next_loop() {
+std::vector<int> EventLoopThreadPool::plan_cpus() const {
+    std::vector<int> cpus(num_threads_, -1);
+    if (affinity_.mode == ThreadAffinity::NONE || num_threads_ == 0) {
+        if (num_threads_ > 0) {
+            LOG_INFO("EventLoopThreadPool - " << num_threads_ << " loop(s), no cpu affinity");
+        }
+        return cpus;
+    }
+
+    utils::CpuTopology topology = utils::CpuTopology::detect();
+    std::vector<int> candidates;
+    if (affinity_.mode == ThreadAffinity::CORE_LIST) {
+        for (int cpu : affinity_.cores) {
+            if (topology.find(cpu) != nullptr) {
+                candidates.push_back(cpu);
+            } else {
+                LOG_WARN("EventLoopThreadPool - cpu " << cpu << " not available, skipped");
+            }
+        }
+    } else {
+        candidates = topology.physical_cores();
+    }
+
+    LOG_INFO("EventLoopThreadPool - topology: " << topology.summary());
+    if (candidates.empty()) {
+        LOG_WARN("EventLoopThreadPool - no usable cpu for affinity, threads left unpinned");
+        return cpus;
+    }
+    if (static_cast<size_t>(num_threads_) > candidates.size()) {
+        LOG_WARN("EventLoopThreadPool - " << num_threads_ << " loops on " << candidates.size()
+                 << " cpu(s), some cpus are shared");
+    }
+
+    for (int i = 0; i < num_threads_; ++i) {
+        cpus[i] = candidates[i % candidates.size()];
+        const utils::CpuInfo* info = topology.find(cpus[i]);
+        LOG_INFO("EventLoopThreadPool - loop " << i << " -> cpu " << cpus[i]
+                 << " (core " << info->core_id << ", package " << info->package_id
+                 << ", node " << info->numa_node << ")"
+                 << (affinity_.numa_local ? ", numa-local memory" : ""));
+    }
+    return cpus;
+}
+
+core::EventLoop* EventLoopThreadPool::get_next_loop(size_t peer_hash) {
     assert(started_);
-    base_loop_->is_in_loop_thread();
+    assert(base_loop_->is_in_loop_thread());
 
-    core::EventLoop* loop = base_loop_;
+    if (loops_.empty()) {
+        return base_loop_;
+    }
+
+    size_t index = 0;
+    switch (strategy_) {
+        case LoadBalance::ROUND_ROBIN:
+            index = static_cast<size_t>(next_);
+            if (static_cast<size_t>(++next_) >= loops_.size()) {
+                next_ = 0;
+            }
+            break;
+        case LoadBalance::LEAST_CONNECTIONS:
+            index = least_connections();
+            break;
+        case LoadBalance::POWER_OF_TWO:
+            index = power_of_two();
+            break;
+        case LoadBalance::PEER_HASH:
+            index = peer_hash % loops_.size();
+            break;
+    }
+
+    ++dispatched_[index];
+    return loops_[index];
+}
+
+int64_t EventLoopThreadPool::loop_connections(size_t index) const {
+    const core::LoopStats& stats = loops_[index]->stats();
+    // 已分配但尚未执行 connection_established 的连接也要算上，
+    // 否则一批 accept 会全部落到同一个线程
+    int64_t in_flight = static_cast<int64_t>(dispatched_[index])
+                      - static_cast<int64_t>(stats.connections_total());
+    return stats.connections() + std::max<int64_t>(in_flight, 0);
+}
+
+double EventLoopThreadPool::loop_load(size_t index) const {
+    const core::EventLoop* loop = loops_[index];
+    if (!loop->stats_enabled()) {
+        // 关闭统计后繁忙度停在关闭时的值，只按连接数比较
+        return static_cast<double>(loop_connections(index) + 1);
+    }
+    // 按 M/M/1 的排队延迟 1/(1-u) 放大，繁忙线程上的每个连接代价更高
+    double utilization = std::min(loop->stats().recent_utilization(), 0.95);
+    return static_cast<double>(loop_connections(index) + 1) / (1.0 - utilization);
+}
 
-    if (!loops_.empty()) {
-        // Round-robin负载均衡
-        loop = loops_[next_];
-        ++next_;
-        if (static_cast<size_t>(next_) >= loops_.size()) {
-            next_ = 0;
+size_t EventLoopThreadPool::least_connections() {
+    // 从轮询位置开始扫描，连接数相同时不总是偏向第一个线程
+    size_t n = loops_.size();
+    size_t start = static_cast<size_t>(next_);
+    next_ = static_cast<int>((start + 1) % n);
+
+    size_t best = start;
+    int64_t best_connections = loop_connections(start);
+    for (size_t i = 1; i < n && best_connections > 0; ++i) {
+        size_t index = (start + i) % n;
+        int64_t connections = loop_connections(index);
+        if (connections < best_connections) {
+            best = index;
+            best_connections = connections;
         }
     }
+    return best;
+}
 
-    return loop;
+size_t EventLoopThreadPool::power_of_two() {
+    size_t n = loops_.size();
+    if (n == 1) {
+        return 0;
+    }
+
+    // xorshift64，只在主线程调用
+    auto next_random = [this]() {
+        rng_state_ ^= rng_state_ << 13;
+        rng_state_ ^= rng_state_ >> 7;
+        rng_state_ ^= rng_state_ << 17;
+        return rng_state_;
+    };
+    size_t a = next_random() % n;
+    size_t b = next_random() % (n - 1);
+    if (b >= a) {
+        ++b;
+    }
+    return loop_load(a) <= loop_load(b) ? a : b;
+}
+
+std::vector<core::EventLoop*> EventLoopThreadPool::get_all_loops() const {
+    assert(started_);
+    if (loops_.empty()) {
+        return {base_loop_};
+    }
+    return loops_;
 }
 
 } // namespace tzzero::net
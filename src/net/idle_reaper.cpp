@@ -0,0 +1,128 @@
+#include "tzzero/net/idle_reaper.h"
+#include "tzzero/net/tcp_connection.h"
+#include "tzzero/core/event_loop.h"
+#include "tzzero/utils/logger.h"
+#include <algorithm>
+#include <cassert>
+
+namespace tzzero::net {
+
+IdleReaper::IdleReaper(core::EventLoop* loop, double timeout_seconds)
+    : loop_(loop)
+    , timeout_ns_(static_cast<int64_t>(timeout_seconds * 1e9))
+    , timer_id_(0)
+    , head_(nullptr)
+    , tail_(nullptr)
+    , size_(0)
+    , reaped_(0)
+{
+}
+
+IdleReaper::~IdleReaper() = default;
+
+void IdleReaper::start() {
+    if (timer_id_ != 0 || timeout_ns_ <= 0) {
+        return;
+    }
+
+    double interval = std::clamp(timeout_ns_ / 1e9, 0.01, 1.0);
+    std::weak_ptr<IdleReaper> weak = shared_from_this();
+    timer_id_ = loop_->run_every(interval, [weak]() {
+        if (auto reaper = weak.lock()) {
+            reaper->reap();
+        }
+    });
+}
+
+void IdleReaper::stop() {
+    if (timer_id_ != 0) {
+        loop_->cancel_timer(timer_id_);
+        timer_id_ = 0;
+    }
+}
+
+void IdleReaper::add(TcpConnection* conn) {
+    assert(loop_->is_in_loop_thread());
+    assert(!conn->idle_linked_);
+
+    conn->last_active_ns_ = loop_->clock().monotonic_ns();
+    conn->idle_prev_ = tail_;
+    conn->idle_next_ = nullptr;
+    if (tail_ != nullptr) {
+        tail_->idle_next_ = conn;
+    } else {
+        head_ = conn;
+    }
+    tail_ = conn;
+    conn->idle_linked_ = true;
+    ++size_;
+}
+
+void IdleReaper::touch(TcpConnection* conn) {
+    conn->last_active_ns_ = loop_->clock().monotonic_ns();
+    if (!conn->idle_linked_ || conn == tail_) {
+        return;
+    }
+
+    // 摘下后接到表尾
+    if (conn->idle_prev_ != nullptr) {
+        conn->idle_prev_->idle_next_ = conn->idle_next_;
+    } else {
+        head_ = conn->idle_next_;
+    }
+    conn->idle_next_->idle_prev_ = conn->idle_prev_;
+
+    conn->idle_prev_ = tail_;
+    conn->idle_next_ = nullptr;
+    tail_->idle_next_ = conn;
+    tail_ = conn;
+}
+
+void IdleReaper::remove(TcpConnection* conn) {
+    assert(loop_->is_in_loop_thread());
+    if (conn->idle_linked_) {
+        unlink(conn);
+    }
+}
+
+void IdleReaper::unlink(TcpConnection* conn) {
+    if (conn->idle_prev_ != nullptr) {
+        conn->idle_prev_->idle_next_ = conn->idle_next_;
+    } else {
+        head_ = conn->idle_next_;
+    }
+    if (conn->idle_next_ != nullptr) {
+        conn->idle_next_->idle_prev_ = conn->idle_prev_;
+    } else {
+        tail_ = conn->idle_prev_;
+    }
+    conn->idle_prev_ = nullptr;
+    conn->idle_next_ = nullptr;
+    conn->idle_linked_ = false;
+    --size_;
+}
+
+void IdleReaper::reap() {
+    assert(loop_->is_in_loop_thread());
+
+    int64_t deadline = loop_->clock().monotonic_ns() - timeout_ns_;
+    while (head_ != nullptr && head_->last_active_ns_ <= deadline) {
+        TcpConnection* conn = head_;
+        unlink(conn);
+        batch_.push_back(conn->shared_from_this());
+    }
+    if (batch_.empty()) {
+        return;
+    }
+
+    // 先整批摘下再关闭，关闭回调里对链表的修改不会影响扫描
+    for (const auto& conn : batch_) {
+        conn->force_close();
+    }
+    reaped_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    LOG_DEBUG("IdleReaper - closed " << batch_.size() << " idle connection(s), "
+              << size_ << " remaining");
+    batch_.clear();
+}
+
+}  // namespace tzzero::net
@@ -0,0 +1,388 @@
+#include "tzzero/net/output_queue.h"
+#include "tzzero/core/frame_pool.h"
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <linux/errqueue.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <utility>
+
+namespace tzzero::net {
+
+namespace {
+
+constexpr uint32_t kInitialSlices = 8;
+
+// 单次 sendfile 最多传输的字节数（内核上限）
+constexpr size_t kMaxSendfile = 0x7ffff000;
+
+}  // anonymous namespace
+
+OpenFile::~OpenFile() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+ZeroCopyState::ZeroCopyState(size_t threshold)
+    : threshold_(std::max(threshold, kMinThreshold))
+{
+}
+
+int ZeroCopyState::read_completions(int fd) {
+    int notifications = 0;
+    while (true) {
+        char control[128];
+        struct msghdr msg{};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (::recvmsg(fd, &msg, MSG_ERRQUEUE) < 0) {
+            // EAGAIN：错误队列已空
+            break;
+        }
+        for (struct cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg, cm)) {
+            bool recverr = (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+                           (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR);
+            if (!recverr) {
+                continue;
+            }
+            const auto* err = reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(cm));
+            if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+            // [ee_info, ee_data] 为这次通知覆盖的发送序号
+            uint32_t count = err->ee_data - err->ee_info + 1;
+            completions_ += count;
+            if (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                copied_ += count;
+            }
+            completed_ = err->ee_data + 1;
+            ++notifications;
+        }
+    }
+
+    // 序号按 32 位回绕比较
+    while (!pins_.empty() && static_cast<int32_t>(pins_.front().seq - completed_) < 0) {
+        pins_.pop_front();
+    }
+    return notifications;
+}
+
+void ZeroCopyState::abandon() {
+    if (!pins_.empty()) {
+        // 有意不释放
+        (void)new std::deque<Pin>(std::move(pins_));
+        pins_.clear();
+    }
+}
+
+void ZeroCopyState::pin(std::string&& owned, std::shared_ptr<const void>&& keep) {
+    if (!outstanding()) {
+        // 引用它的发送都已完成
+        return;
+    }
+    if (owned.empty() && !keep) {
+        // 静态数据不需要暂存
+        return;
+    }
+    pins_.push_back(Pin{issued_ - 1, std::move(owned), std::move(keep)});
+}
+
+OutputQueue::~OutputQueue() {
+    if (ring_ == nullptr) {
+        return;
+    }
+    for (uint32_t i = 0; i < capacity_; ++i) {
+        ring_[i].~Slice();
+    }
+    core::FramePool::deallocate(ring_, capacity_ * sizeof(Slice));
+}
+
+OutputQueue::OutputQueue(OutputQueue&& other) noexcept
+    : ring_(std::exchange(other.ring_, nullptr))
+    , capacity_(std::exchange(other.capacity_, 0))
+    , head_(std::exchange(other.head_, 0))
+    , count_(std::exchange(other.count_, 0))
+    , bytes_(std::exchange(other.bytes_, 0))
+{
+}
+
+OutputQueue& OutputQueue::operator=(OutputQueue&& other) noexcept {
+    if (this != &other) {
+        OutputQueue moved(std::move(other));
+        std::swap(ring_, moved.ring_);
+        std::swap(capacity_, moved.capacity_);
+        std::swap(head_, moved.head_);
+        std::swap(count_, moved.count_);
+        std::swap(bytes_, moved.bytes_);
+    }
+    return *this;
+}
+
+size_t OutputQueue::append(const void* data, size_t len) {
+    if (len == 0) {
+        return 0;
+    }
+    if (!coalesce(static_cast<const char*>(data), len)) {
+        Slice& slice = push_back();
+        slice.owned.assign(static_cast<const char*>(data), len);
+        slice.len = len;
+        bytes_ += len;
+    }
+    return len;
+}
+
+size_t OutputQueue::append(std::string&& data, size_t offset) {
+    assert(offset <= data.size());
+    size_t remaining = data.size() - offset;
+    if (remaining == 0) {
+        return 0;
+    }
+    Slice& slice = push_back();
+    slice.owned = std::move(data);
+    slice.offset = offset;
+    slice.len = slice.owned.size();
+    bytes_ += remaining;
+    return 0;
+}
+
+size_t OutputQueue::append_shared(std::shared_ptr<const std::string> blob, size_t offset) {
+    assert(blob && offset <= blob->size());
+    size_t remaining = blob->size() - offset;
+    if (remaining == 0) {
+        return 0;
+    }
+    Slice& slice = push_back();
+    slice.base = blob->data();
+    slice.offset = offset;
+    slice.len = blob->size();
+    slice.keep = std::move(blob);
+    bytes_ += remaining;
+    return 0;
+}
+
+size_t OutputQueue::append_static(std::string_view data) {
+    if (data.empty()) {
+        return 0;
+    }
+    Slice& slice = push_back();
+    slice.base = data.data();
+    slice.len = data.size();
+    bytes_ += data.size();
+    return 0;
+}
+
+size_t OutputQueue::append_file(std::shared_ptr<const OpenFile> file, off_t offset, size_t len) {
+    assert(file && file->fd() >= 0 && offset >= 0);
+    if (len == 0) {
+        return 0;
+    }
+    Slice& slice = push_back();
+    slice.offset = static_cast<size_t>(offset);
+    slice.len = static_cast<size_t>(offset) + len;
+    slice.file_fd = file->fd();
+    slice.keep = std::move(file);
+    bytes_ += len;
+    return 0;
+}
+
+size_t OutputQueue::append(OutputQueue&& other) {
+    assert(this != &other);
+    if (count_ == 0) {
+        // 本队列为空时直接交换，段原样接过来
+        std::swap(ring_, other.ring_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(head_, other.head_);
+        std::swap(count_, other.count_);
+        std::swap(bytes_, other.bytes_);
+        return 0;
+    }
+
+    while (other.count_ > 0) {
+        Slice& src = other.at(0);
+        Slice& slice = push_back();
+        slice.base = src.base;
+        slice.offset = src.offset;
+        slice.len = src.len;
+        slice.file_fd = src.file_fd;
+        slice.owned = std::move(src.owned);
+        slice.keep = std::move(src.keep);
+        bytes_ += src.remaining();
+        other.pop_front();
+    }
+    other.bytes_ = 0;
+    return 0;
+}
+
+ssize_t OutputQueue::write_to(int fd, int* saved_errno, size_t* attempted, ZeroCopyState* zerocopy) {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    ssize_t n;
+    size_t want = 0;
+    Slice& front = at(0);
+    if (front.file_fd >= 0) {
+        // 文件内容由内核从页缓存直接发出
+        off_t offset = static_cast<off_t>(front.offset);
+        want = std::min(front.remaining(), kMaxSendfile);
+        n = ::sendfile(fd, front.file_fd, &offset, want);
+        if (n == 0) {
+            // 文件在发送过程中被截短，响应已无法完整发出
+            errno = EIO;
+            n = -1;
+        }
+    } else if (zerocopy != nullptr && front.remaining() >= zerocopy->threshold()) {
+        // 大段单独零拷贝发送，内核引用这段内存直到完成通知
+        want = front.remaining();
+        struct iovec iov{const_cast<char*>(front.data()), want};
+        struct msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        n = ::sendmsg(fd, &msg, MSG_ZEROCOPY | (count_ > 1 ? MSG_MORE : 0));
+        if (n >= 0) {
+            front.zerocopy = true;
+            zerocopy->sent();
+        } else if (errno == ENOBUFS) {
+            // 未完成的通知占满了 optmem 配额，这次退回普通发送
+            n = ::write(fd, iov.iov_base, iov.iov_len);
+        }
+    } else {
+        // 连续的内存段一次写出，遇到文件段或要零拷贝发送的大段为止
+        struct iovec iov[kMaxIovecs];
+        int iovcnt = 0;
+        uint32_t limit = std::min<uint32_t>(count_, kMaxIovecs);
+        for (uint32_t i = 0; i < limit; ++i) {
+            Slice& slice = at(i);
+            if (slice.file_fd >= 0 ||
+                (zerocopy != nullptr && slice.remaining() >= zerocopy->threshold())) {
+                break;
+            }
+            iov[iovcnt].iov_base = const_cast<char*>(slice.data());
+            iov[iovcnt].iov_len = slice.remaining();
+            want += slice.remaining();
+            ++iovcnt;
+        }
+        if (static_cast<uint32_t>(iovcnt) < count_) {
+            // 后面还有段要由下一次调用发出（如头部之后的文件段），MSG_MORE 让内核等它们
+            // 凑成整段再发，不单独发一个小报文
+            struct msghdr msg{};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = static_cast<size_t>(iovcnt);
+            n = ::sendmsg(fd, &msg, MSG_MORE);
+        } else if (iovcnt == 1) {
+            n = ::write(fd, iov[0].iov_base, iov[0].iov_len);
+        } else {
+            n = ::writev(fd, iov, iovcnt);
+        }
+    }
+
+    if (attempted != nullptr) {
+        *attempted = want;
+    }
+    if (n < 0) {
+        *saved_errno = errno;
+    } else {
+        consume(static_cast<size_t>(n), zerocopy);
+    }
+    return n;
+}
+
+void OutputQueue::clear(ZeroCopyState* zerocopy) {
+    while (count_ > 0) {
+        pop_front(zerocopy);
+    }
+    bytes_ = 0;
+}
+
+OutputQueue::Slice& OutputQueue::push_back() {
+    if (count_ == capacity_) {
+        grow();
+    }
+    return at(count_++);
+}
+
+void OutputQueue::pop_front(ZeroCopyState* zerocopy) {
+    Slice& front = at(0);
+    if (front.zerocopy) {
+        if (zerocopy != nullptr) {
+            zerocopy->pin(front.base == nullptr ? std::move(front.owned) : std::string(),
+                          std::move(front.keep));
+        }
+        front.zerocopy = false;
+    }
+    front.base = nullptr;
+    front.offset = 0;
+    front.len = 0;
+    front.file_fd = -1;
+    front.keep.reset();
+    // 小字符串留着给后面的段复用，大的释放
+    if (front.owned.capacity() > kCoalesceLimit) {
+        std::string().swap(front.owned);
+    } else {
+        front.owned.clear();
+    }
+    head_ = (head_ + 1) & (capacity_ - 1);
+    --count_;
+}
+
+void OutputQueue::consume(size_t n, ZeroCopyState* zerocopy) {
+    assert(n <= bytes_);
+    bytes_ -= n;
+    while (n > 0) {
+        Slice& front = at(0);
+        size_t remaining = front.remaining();
+        if (n < remaining) {
+            front.offset += n;
+            return;
+        }
+        n -= remaining;
+        pop_front(zerocopy);
+    }
+}
+
+void OutputQueue::grow() {
+    uint32_t capacity = capacity_ == 0 ? kInitialSlices : capacity_ * 2;
+    Slice* ring = static_cast<Slice*>(core::FramePool::allocate(capacity * sizeof(Slice)));
+    for (uint32_t i = 0; i < capacity; ++i) {
+        new (&ring[i]) Slice();
+    }
+    for (uint32_t i = 0; i < count_; ++i) {
+        ring[i] = std::move(at(i));
+    }
+    if (ring_ != nullptr) {
+        for (uint32_t i = 0; i < capacity_; ++i) {
+            ring_[i].~Slice();
+        }
+        core::FramePool::deallocate(ring_, capacity_ * sizeof(Slice));
+    }
+    ring_ = ring;
+    capacity_ = capacity;
+    head_ = 0;
+}
+
+bool OutputQueue::coalesce(const char* data, size_t len) {
+    if (count_ == 0) {
+        return false;
+    }
+    Slice& tail = at(count_ - 1);
+    if (tail.base != nullptr || tail.file_fd >= 0) {
+        return false;
+    }
+    // 尾段已经很大时扩容会整体搬移，不如单独成段；接管来的大字符串同理
+    size_t size = tail.owned.size();
+    if (size + len > tail.owned.capacity() && size + len > kCoalesceLimit) {
+        return false;
+    }
+    tail.owned.append(data, len);
+    tail.len += len;
+    bytes_ += len;
+    return true;
+}
+
+}  // namespace tzzero::net
@@ -0,0 +1,56 @@
+#include "tzzero/net/socket_address.h"
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <cstdint>
+#include <string_view>
+
+namespace tzzero::net {
+
+SocketAddress SocketAddress::local_of(int sockfd) {
+    SocketAddress addr;
+    addr.len_ = addr.capacity();
+    if (::getsockname(sockfd, addr.data(), &addr.len_) != 0) {
+        return SocketAddress{};
+    }
+    return addr;
+}
+
+SocketAddress SocketAddress::peer_of(int sockfd) {
+    SocketAddress addr;
+    addr.len_ = addr.capacity();
+    if (::getpeername(sockfd, addr.data(), &addr.len_) != 0) {
+        return SocketAddress{};
+    }
+    return addr;
+}
+
+std::string SocketAddress::to_string() const {
+    char ip[INET6_ADDRSTRLEN];
+    if (storage_.ss_family == AF_INET) {
+        auto* in = reinterpret_cast<const sockaddr_in*>(&storage_);
+        ::inet_ntop(AF_INET, &in->sin_addr, ip, sizeof(ip));
+        return std::string(ip) + ":" + std::to_string(ntohs(in->sin_port));
+    }
+    if (storage_.ss_family == AF_INET6) {
+        auto* in6 = reinterpret_cast<const sockaddr_in6*>(&storage_);
+        ::inet_ntop(AF_INET6, &in6->sin6_addr, ip, sizeof(ip));
+        return "[" + std::string(ip) + "]:" + std::to_string(ntohs(in6->sin6_port));
+    }
+    return std::string();
+}
+
+size_t SocketAddress::hash_ip() const {
+    if (storage_.ss_family == AF_INET) {
+        auto* in = reinterpret_cast<const sockaddr_in*>(&storage_);
+        // std::hash 对整数是恒等映射，取模时只看到第一个字节，这里先混合
+        return static_cast<size_t>((static_cast<uint64_t>(in->sin_addr.s_addr) * 0x9e3779b97f4a7c15ULL) >> 32);
+    }
+    if (storage_.ss_family == AF_INET6) {
+        auto* in6 = reinterpret_cast<const sockaddr_in6*>(&storage_);
+        return std::hash<std::string_view>{}(std::string_view(
+            reinterpret_cast<const char*>(&in6->sin6_addr), sizeof(in6->sin6_addr)));
+    }
+    return 0;
+}
+
+}  // namespace tzzero::net
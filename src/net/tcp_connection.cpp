@@ -1,4 +1,6 @@
 #include "tzzero/net/tcp_connection.h"
+#include "tzzero/net/idle_reaper.h"
+#include "tzzero/net/connection_registry.h"
 #include "tzzero/core/event_loop.h"
 #include "tzzero/core/poller.h"
 #include "tzzero/utils/logger.h"
@@ -7,43 +9,144 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <cstring>
 #include <cassert>
 
 namespace tzzero::net {
 
-TcpConnection::TcpConnection(core::EventLoop* loop, const std::string& name, int sockfd)
+namespace {
+
+// 未设置回调的连接共用
+const ConnectionCallbacks kNoCallbacks;
+
+// 断开后读取零拷贝完成通知的间隔
+constexpr double kLingerPollSeconds = 0.01;
+// 对端一直不确认时，断开后等这么久以 RST 中止连接
+constexpr int64_t kLingerAbortNs = 30LL * 1000000000;
+
+// 连接断开时仍有未完成的零拷贝发送：持有一个 fd 副本让套接字留着，
+// 由循环定时读取完成通知，全部完成后才释放暂存的数据并关闭
+struct ZeroCopyLinger {
+    ZeroCopyLinger(int linger_fd, std::shared_ptr<ZeroCopyState> zerocopy, int64_t abort_at)
+        : fd(linger_fd), state(std::move(zerocopy)), abort_at_ns(abort_at) {}
+    ZeroCopyLinger(const ZeroCopyLinger&) = delete;
+    ZeroCopyLinger& operator=(const ZeroCopyLinger&) = delete;
+
+    int fd;
+    std::shared_ptr<ZeroCopyState> state;
+    int64_t abort_at_ns;
+    bool aborted = false;
+
+    ~ZeroCopyLinger() {
+        if (state->outstanding()) {
+            // 循环在通知到达前销毁，定时器随之丢弃
+            state->abandon();
+        }
+        ::close(fd);
+    }
+};
+
+void linger_zerocopy(core::EventLoop* loop, std::shared_ptr<ZeroCopyLinger> linger) {
+    linger->state->read_completions(linger->fd);
+    if (!linger->state->outstanding()) {
+        return;
+    }
+    if (!linger->aborted && loop->clock().monotonic_ns() >= linger->abort_at_ns) {
+        // AF_UNSPEC 的 connect 断开 TCP 连接：发 RST 并丢弃发送队列，fd 仍然有效，
+        // 内核释放数据后照常发出完成通知
+        LOG_WARN("TcpConnection - zero-copy sends still unacknowledged, aborting fd=" << linger->fd);
+        struct sockaddr addr{};
+        addr.sa_family = AF_UNSPEC;
+        ::connect(linger->fd, &addr, sizeof(addr));
+        linger->aborted = true;
+    }
+    loop->run_after(kLingerPollSeconds, [loop, linger]() {
+        linger_zerocopy(loop, linger);
+    });
+}
+
+}  // anonymous namespace
+
+template<typename Append>
+void TcpConnection::enqueue_in_loop(Append&& append) {
+    assert(loop_->is_in_loop_thread());
+
+    if (state_ == DISCONNECTED) {
+        // 工作线程投递的响应晚于关闭到达
+        LOG_WARN("TcpConnection::enqueue_in_loop " << get_name() << " disconnected, give up writing");
+        return;
+    }
+    if (idle_linked_) {
+        idle_reaper_->touch(this);
+    }
+
+    size_t old_len = output_queue_.size();
+    size_t copied = append(output_queue_);
+    if (copied > 0) {
+        loop_->output_copied(copied);
+    }
+    queued(old_len);
+}
+
+TcpConnection::TcpConnection(core::EventLoop* loop, uint64_t id, int sockfd,
+                             const SocketAddress& peer)
     : loop_(loop)
-    , name_(name)
-    , state_(CONNECTING)
+    , callbacks_(&kNoCallbacks)
     , socket_fd_(sockfd)
+    , state_(CONNECTING)
+    , edge_triggered_(false)
+    , idle_linked_(false)
+    , batching_(false)
+    , interest_(0)
+    , idle_reaper_(nullptr)
+    , last_active_ns_(0)
+    , idle_prev_(nullptr)
+    , idle_next_(nullptr)
     , high_water_mark_(64 * 1024 * 1024)  // 64MB
+    , id_(id)
+    , registry_slot_(ConnectionRegistry::kNoSlot)
+    , peer_(peer)
 {
-    // 获取本地和对端地址
-    struct sockaddr_in local_addr, peer_addr;
-    socklen_t addr_len = sizeof(local_addr);
-    
-    if (::getsockname(sockfd, reinterpret_cast<struct sockaddr*>(&local_addr), &addr_len) == 0) {
-        char ip_buf[INET_ADDRSTRLEN];
-        ::inet_ntop(AF_INET, &local_addr.sin_addr, ip_buf, INET_ADDRSTRLEN);
-        local_addr_ = std::string(ip_buf) + ":" + std::to_string(ntohs(local_addr.sin_port));
-    }
-
-    addr_len = sizeof(peer_addr);
-    if (::getpeername(sockfd, reinterpret_cast<struct sockaddr*>(&peer_addr), &addr_len) == 0) {
-        char ip_buf[INET_ADDRSTRLEN];
-        ::inet_ntop(AF_INET, &peer_addr.sin_addr, ip_buf, INET_ADDRSTRLEN);
-        peer_addr_ = std::string(ip_buf) + ":" + std::to_string(ntohs(peer_addr.sin_port));
-    }
-    
-    LOG_DEBUG("TcpConnection created: " << name_ << " fd=" << socket_fd_ 
-              << " local=" << local_addr_ << " peer=" << peer_addr_);             
+    LOG_DEBUG("TcpConnection created: " << get_name() << " fd=" << socket_fd_
+              << " local=" << get_local_address() << " peer=" << get_peer_address());
 }
 
 TcpConnection::~TcpConnection() {
-    LOG_DEBUG("TcpConnection destroyed: " << name_ << " fd=" << socket_fd_);
+    LOG_DEBUG("TcpConnection destroyed: " << get_name() << " fd=" << socket_fd_);
     assert(state_ == DISCONNECTED);
+    ::close(socket_fd_);
+}
+
+const std::string& TcpConnection::get_name() const {
+    std::call_once(name_once_, [this]() {
+        name_ = "conn#" + std::to_string(id_);
+    });
+    return name_;
+}
+
+const SocketAddress& TcpConnection::get_peer() const {
+    std::call_once(peer_once_, [this]() {
+        if (!peer_.valid()) {
+            peer_ = SocketAddress::peer_of(socket_fd_);
+        }
+    });
+    return peer_;
+}
+
+const std::string& TcpConnection::get_local_address() const {
+    std::call_once(local_once_, [this]() {
+        local_addr_ = SocketAddress::local_of(socket_fd_).to_string();
+    });
+    return local_addr_;
+}
+
+const std::string& TcpConnection::get_peer_address() const {
+    std::call_once(peer_addr_once_, [this]() {
+        peer_addr_ = get_peer().to_string();
+    });
+    return peer_addr_;
 }
 
 void TcpConnection::send(const void* data, size_t len) {
@@ -77,6 +180,72 @@ void TcpConnection::send(tzzero::utils::Buffer& buffer) {
     }
 }
 
+void TcpConnection::send(std::string&& message) {
+    if (state_ == CONNECTED) {
+        if (loop_->is_in_loop_thread()) {
+            enqueue_in_loop([&message](OutputQueue& queue) { return queue.append(std::move(message)); });
+        } else {
+            loop_->run_in_loop([this, message = std::move(message)]() mutable {
+                enqueue_in_loop([&message](OutputQueue& queue) { return queue.append(std::move(message)); });
+            });
+        }
+    }
+}
+
+void TcpConnection::send_shared(std::shared_ptr<const std::string> blob) {
+    if (state_ == CONNECTED) {
+        if (loop_->is_in_loop_thread()) {
+            enqueue_in_loop([&blob](OutputQueue& queue) { return queue.append_shared(std::move(blob)); });
+        } else {
+            loop_->run_in_loop([this, blob = std::move(blob)]() mutable {
+                enqueue_in_loop([&blob](OutputQueue& queue) { return queue.append_shared(std::move(blob)); });
+            });
+        }
+    }
+}
+
+void TcpConnection::send_static(std::string_view data) {
+    if (state_ == CONNECTED) {
+        if (loop_->is_in_loop_thread()) {
+            enqueue_in_loop([data](OutputQueue& queue) { return queue.append_static(data); });
+        } else {
+            loop_->run_in_loop([this, data]() {
+                enqueue_in_loop([data](OutputQueue& queue) { return queue.append_static(data); });
+            });
+        }
+    }
+}
+
+void TcpConnection::send_file(std::shared_ptr<const OpenFile> file, off_t offset, size_t len) {
+    if (state_ == CONNECTED) {
+        if (loop_->is_in_loop_thread()) {
+            enqueue_in_loop([&file, offset, len](OutputQueue& queue) {
+                return queue.append_file(std::move(file), offset, len);
+            });
+        } else {
+            loop_->run_in_loop([this, file = std::move(file), offset, len]() mutable {
+                enqueue_in_loop([&file, offset, len](OutputQueue& queue) {
+                    return queue.append_file(std::move(file), offset, len);
+                });
+            });
+        }
+    }
+}
+
+void TcpConnection::send(OutputQueue&& pieces) {
+    if (state_ == CONNECTED) {
+        if (loop_->is_in_loop_thread()) {
+            enqueue_in_loop([&pieces](OutputQueue& queue) { return queue.append(std::move(pieces)); });
+        } else {
+            // 任务回调须可拷贝，队列放在共享对象里带过去
+            auto moved = std::make_shared<OutputQueue>(std::move(pieces));
+            loop_->run_in_loop([this, moved]() {
+                enqueue_in_loop([&moved](OutputQueue& queue) { return queue.append(std::move(*moved)); });
+            });
+        }
+    }
+}
+
 void TcpConnection::shutdown() {
     if (state_ == CONNECTED) {
         state_ = DISCONNECTING;
@@ -113,34 +282,53 @@ void TcpConnection::connection_established() {
     assert(state_ == CONNECTING);
     
     state_ = CONNECTED;
-    // 添加到事件循环用于读取
-    loop_->get_poller()->add_fd(socket_fd_, core::Poller::EVENT_READ, 
-        [this](int fd, uint32_t events) {
-            if (events & core::Poller::EVENT_READ) {
-                handle_read();
-            }
-            if (events & core::Poller::EVENT_WRITE) {
-                handle_write();
-            }
-            if (events & core::Poller::EVENT_ERROR) {
-                handle_error();
-            }
-        });
+    self_ = shared_from_this();
+
+    // 添加到事件循环用于读取；边缘触发模式下同时关注可写，之后不再修改
+    interest_ = core::Poller::EVENT_READ;
+    if (edge_triggered_) {
+        interest_ |= core::Poller::EVENT_WRITE | core::Poller::EVENT_EDGE_TRIGGERED;
+    }
+    loop_->get_poller()->add_fd(socket_fd_, interest_, [this](int, uint32_t events) {
+        handle_event(events);
+    });
+
+    if (idle_reaper_) {
+        idle_reaper_->add(this);
+    }
+    loop_->connection_opened();
 }
 
 void TcpConnection::connection_destroyed() {
     assert(loop_->is_in_loop_thread());
     
+    // 函数返回时释放自身引用，没有其他持有者时连接在此析构
+    std::shared_ptr<TcpConnection> guard = std::move(self_);
     if (state_ == CONNECTED) {
         state_ = DISCONNECTED;
         loop_->get_poller()->remove_fd(socket_fd_);
+        on_disconnected();
         
-        if (close_callback_) {
-            close_callback_(shared_from_this());
+        if (callbacks_->close) {
+            callbacks_->close(guard);
         }
     }
 }
 
+void TcpConnection::pause_idle_timeout() {
+    assert(loop_->is_in_loop_thread());
+    if (idle_linked_) {
+        idle_reaper_->remove(this);
+    }
+}
+
+void TcpConnection::resume_idle_timeout() {
+    assert(loop_->is_in_loop_thread());
+    if (idle_reaper_ && !idle_linked_ && state_ != DISCONNECTED) {
+        idle_reaper_->add(this);
+    }
+}
+
 void TcpConnection::set_tcp_no_delay(bool on) {
     int optval = on ? 1 : 0;
     ::setsockopt(socket_fd_, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof(optval));
@@ -151,20 +339,112 @@ void TcpConnection::set_keep_alive(bool on) {
     ::setsockopt(socket_fd_, SOL_SOCKET, SO_KEEPALIVE, &optval, sizeof(optval));
 }
 
+void TcpConnection::set_busy_poll(int usec) {
+#ifdef SO_BUSY_POLL
+    // 超过 net.core.busy_read 需要 CAP_NET_ADMIN
+    if (::setsockopt(socket_fd_, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec)) < 0) {
+        LOG_DEBUG("TcpConnection::set_busy_poll SO_BUSY_POLL failed: " << strerror(errno));
+    }
+#endif
+#ifdef SO_PREFER_BUSY_POLL
+    int prefer = usec > 0 ? 1 : 0;
+    if (::setsockopt(socket_fd_, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer)) < 0) {
+        LOG_DEBUG("TcpConnection::set_busy_poll SO_PREFER_BUSY_POLL failed: " << strerror(errno));
+    }
+#endif
+    (void)usec;
+}
+
+void TcpConnection::set_zerocopy_threshold(size_t bytes) {
+    if (bytes == 0) {
+        zerocopy_.reset();
+        return;
+    }
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    int one = 1;
+    if (::setsockopt(socket_fd_, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) < 0) {
+        LOG_DEBUG("TcpConnection::set_zerocopy_threshold SO_ZEROCOPY failed: " << strerror(errno));
+        return;
+    }
+    zerocopy_ = std::make_shared<ZeroCopyState>(bytes);
+#endif
+}
+
+void TcpConnection::handle_event(uint32_t events) {
+    if (events & core::Poller::EVENT_READ) {
+        handle_read();
+    }
+    if (events & core::Poller::EVENT_WRITE) {
+        handle_write();
+    }
+    if (events & core::Poller::EVENT_ERROR) {
+        // 零拷贝完成通知放在错误队列中，同样以 EPOLLERR 报告
+        if (zerocopy_ && handle_zerocopy_completions()) {
+            return;
+        }
+        handle_error();
+    }
+}
+
+bool TcpConnection::handle_zerocopy_completions() {
+    if (state_ == DISCONNECTED) {
+        return true;
+    }
+    if (zerocopy_->read_completions(socket_fd_) == 0) {
+        return false;
+    }
+    int err = 0;
+    socklen_t len = sizeof(err);
+    ::getsockopt(socket_fd_, SOL_SOCKET, SO_ERROR, &err, &len);
+    if (err != 0) {
+        errno = err;
+        LOG_ERROR("TcpConnection::handle_zerocopy_completions - SO_ERROR: " << strerror(err));
+        return false;
+    }
+    return true;
+}
+
 void TcpConnection::handle_read() {
     assert(loop_->is_in_loop_thread());
     
     int saved_errno = 0;
-    ssize_t n = input_buffer_.read_fd(socket_fd_, &saved_errno);
-    
-    if (n > 0) {
-        if (message_callback_) {
-            message_callback_(shared_from_this(), input_buffer_);
+    size_t total = 0;
+    ssize_t n;
+
+    while (true) {
+        // read_fd 最多读入可写空间加 64KB 栈缓冲
+        size_t capacity = input_buffer_.writable_bytes() + 65536;
+        n = input_buffer_.read_fd(socket_fd_, &saved_errno);
+        if (n <= 0) {
+            break;
+        }
+        total += static_cast<size_t>(n);
+        // 水平触发只读一次；边缘触发读到不足请求量说明内核缓冲已空，省掉一次 EAGAIN
+        if (!edge_triggered_ || static_cast<size_t>(n) < capacity) {
+            break;
         }
     }
-    else if (n == 0) {
+
+    if (total > 0) {
+        if (idle_linked_) {
+            idle_reaper_->touch(this);
+        }
+        if (callbacks_->message) {
+            // 回调中产生的响应先排队，返回后一起写出
+            size_t pending = output_queue_.size();
+            batching_ = true;
+            callbacks_->message(self_, input_buffer_);
+            batching_ = false;
+            // 原先有数据待发时正在等可写事件，不用写
+            if (pending == 0 && !output_queue_.empty() && state_ != DISCONNECTED) {
+                write_output();
+            }
+        }
+    }
+
+    if (n == 0) {
         handle_close();
-    } else {
+    } else if (n < 0 && saved_errno != EAGAIN && saved_errno != EWOULDBLOCK) {
         errno = saved_errno;
         LOG_ERROR("TcpConnection::handle_read error: " << strerror(saved_errno));
         handle_error();
@@ -174,52 +454,79 @@ void TcpConnection::handle_read() {
 void TcpConnection::handle_write() {
     assert(loop_->is_in_loop_thread());
     
-    if (state_ == CONNECTED) {
-        int saved_errno = 0;
-        ssize_t n = output_buffer_.write_fd(socket_fd_, &saved_errno);
-
-        if (n > 0) {
-            if (output_buffer_.readable_bytes() == 0) {
-                loop_->get_poller()->modify_fd(socket_fd_, core::Poller::EVENT_READ, 
-                    [this](int fd, uint32_t events) {
-                        if (events & core::Poller::EVENT_READ) {
-                            handle_read();
-                        }
-                        if (events & core::Poller::EVENT_WRITE) {
-                            handle_write();
-                        }
-                        if (events & core::Poller::EVENT_ERROR) {
-                            handle_error();
-                        }
-                    });
-
-                if (write_complete_callback_) {
-                    loop_->queue_in_loop([this]() {
-                        write_complete_callback_(shared_from_this());
-                    });
-                }
+    if (state_ != CONNECTED && state_ != DISCONNECTING) {
+        return;
+    }
+    if (output_queue_.empty()) {
+        // 边缘触发下可写事件不关心是否有数据待发
+        return;
+    }
 
-                if (state_ == DISCONNECTING) {
-                    shutdown_in_loop();
-                }
-            }
-        } else {
-            LOG_ERROR("TcpConnection::handle_write error: " << strerror(saved_errno));
-        }
+    // 对端仍在接收，慢速下载不算空闲
+    if (write_output() && idle_linked_) {
+        idle_reaper_->touch(this);
     }
 }
 
+bool TcpConnection::write_output() {
+    int saved_errno = 0;
+    ssize_t n;
+    while (true) {
+        size_t attempted = 0;
+        n = output_queue_.write_to(socket_fd_, &saved_errno, &attempted, zerocopy_.get());
+        loop_->output_syscall();
+        // 只写出一部分说明发送缓冲已满，等待下一次可写事件；
+        // 写完了这一批但队列还有（文件段、零拷贝大段或超过 IOV_MAX 的段）时接着写
+        if (n <= 0 || output_queue_.empty() || static_cast<size_t>(n) < attempted) {
+            break;
+        }
+    }
+
+    if (n < 0) {
+        if (saved_errno == EAGAIN || saved_errno == EWOULDBLOCK) {
+            enable_writing();
+            return true;
+        }
+        // 对端不再接收，或文件区间读取失败、响应已无法完整发出：丢弃待发数据并关闭
+        LOG_ERROR("TcpConnection::write_output error: " << strerror(saved_errno));
+        output_queue_.clear();
+        handle_close();
+        return false;
+    }
+
+    if (output_queue_.empty()) {
+        disable_writing();
+
+        if (callbacks_->write_complete) {
+            // 任务持有引用：执行前连接可能已被销毁（self_ 已释放）
+            loop_->queue_in_loop([self = self_]() {
+                self->callbacks_->write_complete(self);
+            });
+        }
+
+        if (state_ == DISCONNECTING) {
+            shutdown_in_loop();
+        }
+    } else {
+        enable_writing();
+    }
+    return true;
+}
 
 void TcpConnection::handle_close() {
     assert(loop_->is_in_loop_thread());
+    if (state_ == DISCONNECTED) {
+        // 同一次事件中读错误和 EVENT_ERROR 可能先后触发关闭
+        return;
+    }
     assert(state_ == CONNECTED || state_ == DISCONNECTING);
     
     state_ = DISCONNECTED;
     loop_->get_poller()->remove_fd(socket_fd_);
+    on_disconnected();
     
-    auto guard_this = shared_from_this();
-    if (close_callback_) {
-        close_callback_(guard_this);
+    if (callbacks_->close) {
+        callbacks_->close(self_);
     }
 }
 
@@ -241,15 +548,27 @@ void TcpConnection::send_in_loop(const void* data, size_t len) {
     ssize_t nwrote = 0;
     size_t remaining = len;
     bool fault_error = false;
+
+    if (state_ == DISCONNECTED) {
+        // 工作线程投递的响应晚于关闭到达
+        LOG_WARN("TcpConnection::send_in_loop " << get_name() << " disconnected, give up writing");
+        return;
+    }
     
-    if (state_ == CONNECTED && output_buffer_.readable_bytes() == 0) {
+    // 工作线程中的慢处理器返回时连接可能已静默很久，发出响应也算活动
+    if (idle_linked_) {
+        idle_reaper_->touch(this);
+    }
+
+    if (state_ == CONNECTED && output_queue_.empty() && !batching_) {
         // 尝试直接写入
         nwrote = ::write(socket_fd_, data, len);
+        loop_->output_syscall();
         if (nwrote >= 0) {
             remaining = len - nwrote;
-            if (remaining == 0 && write_complete_callback_) {
-                loop_->queue_in_loop([this]() {
-                    write_complete_callback_(shared_from_this());
+            if (remaining == 0 && callbacks_->write_complete) {
+                loop_->queue_in_loop([self = self_]() {
+                    self->callbacks_->write_complete(self);
                 });
             }
         } else {
@@ -265,40 +584,88 @@ void TcpConnection::send_in_loop(const void* data, size_t len) {
     
     assert(remaining <= len);
     if (!fault_error && remaining > 0) {
-        size_t old_len = output_buffer_.readable_bytes();
+        size_t old_len = output_queue_.size();
         if (old_len + remaining >= high_water_mark_ && old_len < high_water_mark_ && high_water_mark_callback_) {
-            loop_->queue_in_loop([this, old_len, remaining]() {
-                high_water_mark_callback_(shared_from_this(), old_len + remaining);
+            loop_->queue_in_loop([self = self_, old_len, remaining]() {
+                self->high_water_mark_callback_(self, old_len + remaining);
             });
         }
         
-        output_buffer_.append(static_cast<const char*>(data) + nwrote, remaining);
-        
-                        // 启用写入
-                loop_->get_poller()->modify_fd(socket_fd_, 
-                                             core::Poller::EVENT_READ | core::Poller::EVENT_WRITE, 
-                                             [this](int fd, uint32_t events) {
-                                                 if (events & core::Poller::EVENT_READ) {
-                                                     handle_read();
-                                                 }
-                                                 if (events & core::Poller::EVENT_WRITE) {
-                                                     handle_write();
-                                                 }
-                                                 if (events & core::Poller::EVENT_ERROR) {
-                                                     handle_error();
-                                                 }
-                                             });
+        loop_->output_copied(output_queue_.append(static_cast<const char*>(data) + nwrote, remaining));
+        if (!batching_) {
+            enable_writing();
+        }
+    }
+}
+
+void TcpConnection::queued(size_t old_len) {
+    if (output_queue_.size() == old_len) {
+        return;
+    }
+    if (batching_) {
+        // 读事件分发结束时一起写出，原先有数据待发时已在等可写事件
+    } else if (old_len == 0 && state_ == CONNECTED) {
+        write_output();
+    } else {
+        enable_writing();
+    }
+
+    size_t new_len = output_queue_.size();
+    if (new_len >= high_water_mark_ && old_len < high_water_mark_ && high_water_mark_callback_) {
+        loop_->queue_in_loop([self = self_, new_len]() {
+            self->high_water_mark_callback_(self, new_len);
+        });
     }
 }
 
 void TcpConnection::shutdown_in_loop() {
     assert(loop_->is_in_loop_thread());
     
-    if (output_buffer_.readable_bytes() == 0) {
+    if (output_queue_.empty()) {
         ::shutdown(socket_fd_, SHUT_WR);
     }
 }
 
+void TcpConnection::enable_writing() {
+    if (!edge_triggered_) {
+        update_interest(interest_ | core::Poller::EVENT_WRITE);
+    }
+}
+
+void TcpConnection::disable_writing() {
+    if (!edge_triggered_) {
+        update_interest(interest_ & ~core::Poller::EVENT_WRITE);
+    }
+}
+
+void TcpConnection::update_interest(uint32_t events) {
+    if (events == interest_ || state_ == DISCONNECTED) {
+        return;
+    }
+    interest_ = events;
+    loop_->get_poller()->update_fd(socket_fd_, events);
+}
+
+void TcpConnection::on_disconnected() {
+    if (idle_linked_) {
+        idle_reaper_->remove(this);
+    }
+    // 不会再发送，尽早释放待发数据持有的共享引用；零拷贝发出过的段交给状态暂存
+    output_queue_.clear(zerocopy_.get());
+    if (zerocopy_ && zerocopy_->outstanding()) {
+        // 内核还在发送或重传暂存的数据，连接关闭 fd 后仍须等到完成通知
+        int fd = ::fcntl(socket_fd_, F_DUPFD_CLOEXEC, 0);
+        if (fd < 0) {
+            LOG_ERROR("TcpConnection::on_disconnected dup failed: " << strerror(errno));
+            zerocopy_->abandon();
+        } else {
+            linger_zerocopy(loop_, std::make_shared<ZeroCopyLinger>(
+                fd, zerocopy_, loop_->clock().monotonic_ns() + kLingerAbortNs));
+        }
+    }
+    loop_->connection_closed();
+}
+
 void TcpConnection::force_close_in_loop() {
     assert(loop_->is_in_loop_thread());
     
@@ -1,25 +1,59 @@
 #include "tzzero/net/tcp_server.h"
 #include "tzzero/net/acceptor.h"
+#include "tzzero/net/idle_reaper.h"
+#include "tzzero/net/connection_registry.h"
 #include "tzzero/net/event_loop_thread_pool.h"
 #include "tzzero/core/event_loop.h"
+#include "tzzero/core/frame_pool.h"
 #include "tzzero/utils/logger.h"
+#include <algorithm>
 #include <cassert>
 
 namespace tzzero::net {
 
+struct TcpServer::LoopContext {
+    LoopContext(core::EventLoop* io_loop, uint64_t first_id, uint64_t id_step)
+        : loop(io_loop), next_id(first_id), id_step(id_step) {}
+
+    core::EventLoop* loop;
+    ConnectionRegistry connections;
+    std::shared_ptr<IdleReaper> idle_reaper;
+    Acceptor* acceptor = nullptr;   // 各自监听时本线程的监听器
+
+    // 启动时从服务器复制，连接在本线程创建，不再回头访问服务器对象
+    std::string server_name;
+    ConnectionCallback connection_callback;
+    ConnectionCallbacks callbacks;   // 本线程的连接共用，连接只保存指针
+    bool edge_triggered = false;
+    int busy_poll_us = 0;
+    size_t zerocopy_threshold = 0;
+
+    // 连接 ID 按线程交错：第 i 个线程分配 i+1, i+1+n, ...，线程间不共享计数器
+    uint64_t next_id;
+    uint64_t id_step;
+};
+
 TcpServer::TcpServer(core::EventLoop* loop, const std::string& listen_addr,
                      uint16_t port, const std::string& name)
     : loop_(loop)
     , ip_port_(listen_addr + ":" + std::to_string(port))
     , name_(name)
+    , listen_addr_(listen_addr)
+    , port_(port)
     , acceptor_(std::make_unique<Acceptor>(loop, listen_addr, port))
     , thread_pool_(std::make_unique<EventLoopThreadPool>(loop))
     , started_(false)
-    , next_conn_id_(1)
+    , edge_triggered_(false)
+    , busy_poll_us_(0)
+    , zerocopy_threshold_(0)
+    , idle_timeout_(0)
+    , batch_accept_(true)
+    , accept_per_loop_(false)
+    , cpu_steering_(false)
 {
     acceptor_->set_new_connection_callback(
-        [this](int sockfd, const std::string& peer_addr) {
-            new_connection(sockfd, peer_addr);
+        [this](AcceptedSocket& accepted) {
+            new_connection(accepted);
         });
 }
 
@@ -27,10 +61,18 @@ TcpServer::~TcpServer() {
     assert(loop_->is_in_loop_thread());
     LOG_DEBUG("TcpServer::~TcpServer [" << name_ << "] destructing");
 
-    for (auto& item : connections_) {
-        TcpConnectionPtr conn = item.second;
-        conn->get_loop()->run_in_loop([conn]() {
-            conn->connection_destroyed();
+    // 各线程销毁自己的连接；任务持有上下文，本对象析构后仍然有效。
+    // 本线程的循环直接执行；I/O线程随后由线程池退出，循环在返回前执行已投递的任务，
+    // 即使退出时这个任务还没轮到，连接也会被销毁
+    for (auto& item : loop_contexts_) {
+        LoopContextPtr context = item.second;
+        if (context->idle_reaper) {
+            context->idle_reaper->stop();
+        }
+        context->loop->run_in_loop([context]() {
+            for (const TcpConnectionPtr& conn : context->connections.take_all()) {
+                conn->connection_destroyed();
+            }
         });
     }
 }
@@ -40,91 +82,243 @@ void TcpServer::start() {
         return; // 已经启动
     }
 
-    thread_pool_->start();
-
-    assert(!acceptor_->listening());
-    loop_->run_in_loop([this]() {
-        acceptor_->listen();
+    int busy_poll_us = busy_poll_us_;
+    thread_pool_->start([busy_poll_us](core::EventLoop* loop) {
+        if (busy_poll_us > 0) {
+            loop->set_busy_poll(busy_poll_us);
+        }
     });
 
+    std::vector<core::EventLoop*> loops = thread_pool_->get_all_loops();
+    for (size_t i = 0; i < loops.size(); ++i) {
+        core::EventLoop* loop = loops[i];
+        auto context = std::make_shared<LoopContext>(loop, i + 1, loops.size());
+        context->server_name = name_;
+        context->connection_callback = connection_callback_;
+        // 关闭回调只带上下文的裸指针。上下文比注册在其中的连接活得久：
+        // 析构服务器时取走连接的任务持有它，在此之前投递的建立和销毁任务都排在该任务前面
+        LoopContext* ctx = context.get();
+        context->callbacks.message = message_callback_;
+        context->callbacks.write_complete = write_complete_callback_;
+        context->callbacks.close = [ctx](const TcpConnectionPtr& conn) {
+            remove_connection(*ctx, conn);
+        };
+        context->edge_triggered = edge_triggered_;
+        context->busy_poll_us = busy_poll_us_;
+        context->zerocopy_threshold = zerocopy_threshold_;
+        if (idle_timeout_ > 0) {
+            context->idle_reaper = std::make_shared<IdleReaper>(loop, idle_timeout_);
+            context->idle_reaper->start();
+        }
+        loop_contexts_[loop] = context;
+    }
+
+    if (accept_per_loop_ && thread_pool_->get_all_loops().front() != loop_) {
+        start_loop_acceptors();
+    } else {
+        assert(!acceptor_->listening());
+        if (batch_accept_) {
+            acceptor_->set_new_connections_callback(
+                [this](std::vector<AcceptedSocket>& batch) {
+                    new_connections(batch);
+                });
+        }
+        loop_->run_in_loop([this]() {
+            acceptor_->listen();
+        });
+    }
+
     LOG_INFO("TcpServer [" << name_ << "] started on " << ip_port_);
 }
 
+void TcpServer::start_loop_acceptors() {
+    std::vector<core::EventLoop*> loops = thread_pool_->get_all_loops();
+    // 在当前线程按顺序 bind，第 i 个套接字即组内下标 i，对应第 i 个I/O线程
+    for (core::EventLoop* io_loop : loops) {
+        auto acceptor = std::make_unique<Acceptor>(io_loop, listen_addr_, port_);
+        acceptor->set_new_connection_callback(
+            [this, io_loop](AcceptedSocket& accepted) {
+                new_connection_in_loop(io_loop, accepted);
+            });
+        acceptor->bind();
+        loop_contexts_.at(io_loop)->acceptor = acceptor.get();
+        loop_acceptors_.push_back(std::move(acceptor));
+    }
+
+    if (cpu_steering_ && !loop_acceptors_.front()->attach_cpu_steering(loops.size())) {
+        LOG_WARN("TcpServer [" << name_ << "] CPU steering unavailable, using kernel hash");
+    }
+
+    for (size_t i = 0; i < loops.size(); ++i) {
+        Acceptor* acceptor = loop_acceptors_[i].get();
+        loops[i]->run_in_loop([acceptor]() {
+            acceptor->listen();
+        });
+    }
+
+    LOG_INFO("TcpServer [" << name_ << "] accepting on " << loops.size() << " I/O loops");
+}
+
 void TcpServer::stop() {
     LOG_INFO("TcpServer [" << name_ << "] stopping");
 
-    // 在主线程中执行关闭操作
+    // 1. 停止接受新连接
     loop_->run_in_loop([this]() {
-        // 1. 停止接受新连接
         acceptor_->disable_listening();
+    });
 
-        // 2. 关闭所有现有连接
-        for (auto& item : connections_) {
-            TcpConnectionPtr conn = item.second;
-            // 在连接所属的IO线程中关闭连接
-            conn->get_loop()->run_in_loop([conn]() {
+    // 2. 各I/O线程关闭自己的监听器和现有连接
+    for (auto& item : loop_contexts_) {
+        LoopContextPtr context = item.second;
+        context->loop->run_in_loop([context]() {
+            if (context->acceptor) {
+                context->acceptor->disable_listening();
+            }
+            context->connections.for_each([](const TcpConnectionPtr& conn) {
                 conn->shutdown();
             });
-        }
-    });
+        });
+    }
 
     LOG_INFO("TcpServer [" << name_ << "] stopped");
 }
 
-void TcpServer::set_thread_num(int num_threads) {
+void TcpServer::set_thread_num(int num_threads, const ThreadAffinity& affinity) {
     assert(!started_);
     thread_pool_->set_thread_num(num_threads);
+    thread_pool_->set_affinity(affinity);
 }
 
-void TcpServer::new_connection(int sockfd, const std::string& peer_addr) {
-    assert(loop_->is_in_loop_thread());
+void TcpServer::set_load_balance(LoadBalance strategy) {
+    assert(!started_);
+    thread_pool_->set_load_balance(strategy);
+}
 
-    char buf[64];
-    snprintf(buf, sizeof(buf), "-%s#%d", ip_port_.c_str(), next_conn_id_++);
-    std::string conn_name = name_ + buf;
+uint64_t TcpServer::reaped_connections() const {
+    uint64_t total = 0;
+    for (const auto& item : loop_contexts_) {
+        if (item.second->idle_reaper) {
+            total += item.second->idle_reaper->reaped();
+        }
+    }
+    return total;
+}
 
-    LOG_INFO("TcpServer::new_connection [" << name_ << "] - new connection ["
-             << conn_name << "] from " << peer_addr);
+std::vector<int64_t> TcpServer::connection_counts() const {
+    std::vector<int64_t> counts;
+    for (core::EventLoop* loop : thread_pool_->get_all_loops()) {
+        counts.push_back(loop->stats().connections());
+    }
+    return counts;
+}
 
-    // 选择一个EventLoop处理此连接
-    core::EventLoop* io_loop = thread_pool_->get_next_loop();
+void TcpServer::new_connection(AcceptedSocket& accepted) {
+    assert(loop_->is_in_loop_thread());
 
-    TcpConnectionPtr conn = std::make_shared<TcpConnection>(io_loop, conn_name, sockfd);
-    connections_[conn_name] = conn;
+    core::EventLoop* io_loop = pick_loop(accepted);
 
-    conn->set_message_callback(message_callback_);
-    conn->set_close_callback([this](const TcpConnectionPtr& conn) {
-        remove_connection(conn);
+    // 连接在所属线程中创建，对象和缓冲都从该线程的池分配
+    LoopContextPtr context = loop_contexts_.at(io_loop);
+    io_loop->run_in_loop([context, accepted]() {
+        establish(*context, create_connection(*context, accepted));
     });
-    conn->set_write_complete_callback(write_complete_callback_);
+}
 
-    io_loop->run_in_loop([conn]() {
-        conn->connection_established();
-    });
+void TcpServer::new_connections(std::vector<AcceptedSocket>& batch) {
+    assert(loop_->is_in_loop_thread());
+
+    // 按目标线程分组，I/O线程数很少，线性查找即可
+    std::vector<std::pair<core::EventLoop*, std::vector<AcceptedSocket>>> groups;
+    for (AcceptedSocket& accepted : batch) {
+        core::EventLoop* io_loop = pick_loop(accepted);
+
+        auto group = std::find_if(groups.begin(), groups.end(),
+                                  [io_loop](const auto& item) { return item.first == io_loop; });
+        if (group == groups.end()) {
+            groups.emplace_back(io_loop, std::vector<AcceptedSocket>{});
+            group = groups.end() - 1;
+        }
+        group->second.push_back(accepted);
+    }
 
-    if (connection_callback_) {
-        connection_callback_(conn);
+    for (auto& group : groups) {
+        // 每个线程一个任务，最多一次唤醒
+        LoopContextPtr context = loop_contexts_.at(group.first);
+        group.first->run_in_loop([context, sockets = std::move(group.second)]() {
+            for (const AcceptedSocket& accepted : sockets) {
+                establish(*context, create_connection(*context, accepted));
+            }
+        });
     }
 }
 
-void TcpServer::remove_connection(const TcpConnectionPtr& conn) {
-    loop_->run_in_loop([this, conn]() {
-        remove_connection_in_loop(conn);
-    });
+core::EventLoop* TcpServer::pick_loop(AcceptedSocket& accepted) {
+    if (thread_pool_->load_balance() != LoadBalance::PEER_HASH) {
+        return thread_pool_->get_next_loop();
+    }
+    // 只按 IP 哈希，同一客户端的连接落在同一线程；io_uring accept 没有带回地址时补查
+    if (!accepted.peer.valid()) {
+        accepted.peer = SocketAddress::peer_of(accepted.fd);
+    }
+    return thread_pool_->get_next_loop(accepted.peer.hash_ip());
 }
 
-void TcpServer::remove_connection_in_loop(const TcpConnectionPtr& conn) {
-    assert(loop_->is_in_loop_thread());
+void TcpServer::new_connection_in_loop(core::EventLoop* io_loop, AcceptedSocket& accepted) {
+    assert(io_loop->is_in_loop_thread());
+
+    LoopContext& context = *loop_contexts_.at(io_loop);
+    establish(context, create_connection(context, accepted));
+}
+
+TcpConnectionPtr TcpServer::create_connection(LoopContext& context, const AcceptedSocket& accepted) {
+    assert(context.loop->is_in_loop_thread());
+
+    uint64_t id = context.next_id;
+    context.next_id += context.id_step;
+    // 对象与控制块一次分配，来自本线程的帧池，关闭后留给下一个连接
+    TcpConnectionPtr conn = std::allocate_shared<TcpConnection>(
+        core::PoolAllocator<TcpConnection>(), context.loop, id, accepted.fd, accepted.peer);
+
+    LOG_DEBUG("TcpServer::new_connection [" << context.server_name << "] - new connection ["
+             << conn->get_name() << "] from " << conn->get_peer_address());
+
+    // 回调和回收器由上下文持有，连接只保存指针
+    conn->set_callbacks(&context.callbacks);
+    conn->set_edge_triggered(context.edge_triggered);
+    if (context.busy_poll_us > 0) {
+        conn->set_busy_poll(context.busy_poll_us);
+    }
+    if (context.zerocopy_threshold > 0) {
+        conn->set_zerocopy_threshold(context.zerocopy_threshold);
+    }
+    conn->set_idle_reaper(context.idle_reaper.get());
+    return conn;
+}
+
+void TcpServer::establish(LoopContext& context, const TcpConnectionPtr& conn) {
+    assert(context.loop->is_in_loop_thread());
+    context.connections.add(conn);
+    conn->connection_established();
+    if (context.connection_callback) {
+        context.connection_callback(conn);
+    }
+}
 
-    LOG_INFO("TcpServer::remove_connection_in_loop [" << name_ << "] - connection " << conn->get_name());
+void TcpServer::remove_connection(LoopContext& context, const TcpConnectionPtr& conn) {
+    assert(context.loop->is_in_loop_thread());
 
-    size_t n = connections_.erase(conn->get_name());
-    (void)n;
-    assert(n == 1);
+    LOG_DEBUG("TcpServer::remove_connection - connection " << conn->get_name());
+
+    // 服务器析构时连接可能已被 take_all 取走
+    if (!context.connections.remove(conn.get())) {
+        return;
+    }
 
-    core::EventLoop* io_loop = conn->get_loop();
-    io_loop->queue_in_loop([conn]() {
-        conn->connection_destroyed();
+    // 仍在连接自己的事件处理中，销毁推迟到本轮末尾，同一线程不需要唤醒。
+    // 连接的自身引用保活到 connection_destroyed，任务只带裸指针
+    TcpConnection* raw = conn.get();
+    context.loop->queue_in_loop([raw]() {
+        raw->connection_destroyed();
     });
 }
 
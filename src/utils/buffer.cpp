@@ -1,4 +1,5 @@
 #include "tzzero/utils/buffer.h"
+#include "tzzero/core/frame_pool.h"
 #include <sys/uio.h>
 #include <unistd.h>
 #include <arpa/inet.h>
@@ -9,44 +10,55 @@
 namespace tzzero::utils {
 
 Buffer::Buffer(size_t initial_size)
-    : buffer_(kCheapPrepend + initial_size)
+    : data_(static_cast<char*>(core::FramePool::allocate(kCheapPrepend + initial_size)))
+    , capacity_(kCheapPrepend + initial_size)
     , read_index_(kCheapPrepend)
     , write_index_(kCheapPrepend)
 {
 }
 
+Buffer::~Buffer() {
+    if (data_ != nullptr) {
+        core::FramePool::deallocate(data_, capacity_);
+    }
+}
+
 Buffer::Buffer(const Buffer& other)
-    : buffer_(other.buffer_)
+    : data_(nullptr)
+    , capacity_(other.capacity_)
     , read_index_(other.read_index_)
     , write_index_(other.write_index_)
 {
+    if (other.data_ != nullptr) {
+        data_ = static_cast<char*>(core::FramePool::allocate(capacity_));
+        std::memcpy(data_, other.data_, write_index_);
+    }
 }
 
 Buffer& Buffer::operator=(const Buffer& other) {
     if (this != &other) {
-        buffer_ = other.buffer_;
-        read_index_ = other.read_index_;
-        write_index_ = other.write_index_;
+        Buffer copy(other);
+        swap(copy);
     }
     return *this;
 }
 
 Buffer::Buffer(Buffer&& other) noexcept
-    : buffer_(std::move(other.buffer_))
+    : data_(other.data_)
+    , capacity_(other.capacity_)
     , read_index_(other.read_index_)
     , write_index_(other.write_index_)
 {
+    other.data_ = nullptr;
+    other.capacity_ = 0;
     other.read_index_ = kCheapPrepend;
     other.write_index_ = kCheapPrepend;
 }
 
 Buffer& Buffer::operator=(Buffer&& other) noexcept {
     if (this != &other) {
-        buffer_ = std::move(other.buffer_);
-        read_index_ = other.read_index_;
-        write_index_ = other.write_index_;
-        other.read_index_ = kCheapPrepend;
-        other.write_index_ = kCheapPrepend;
+        Buffer moved(std::move(other));
+        swap(moved);
     }
     return *this;
 }
@@ -191,7 +203,7 @@ ssize_t Buffer::read_fd(int fd, int* saved_errno) {
     } else if (static_cast<size_t>(n) <= writable) {
         write_index_ += n;
     } else {
-        write_index_ = buffer_.size();
+        write_index_ = capacity_;
         append(extrabuf, n - writable);
     }
     
@@ -235,15 +247,23 @@ std::string Buffer::to_string() const {
 }
 
 void Buffer::swap(Buffer& other) noexcept {
-    buffer_.swap(other.buffer_);
+    std::swap(data_, other.data_);
+    std::swap(capacity_, other.capacity_);
     std::swap(read_index_, other.read_index_);
     std::swap(write_index_, other.write_index_);
 }
 
 void Buffer::make_space(size_t len) {
     if (writable_bytes() + prependable_bytes() < len + kCheapPrepend) {
-        // 扩大缓冲区
-        buffer_.resize(write_index_ + len);
+        // 扩大缓冲区，至少翻倍以摊薄多次追加的拷贝
+        size_t capacity = std::max(write_index_ + len, capacity_ * 2);
+        char* data = static_cast<char*>(core::FramePool::allocate(capacity));
+        if (data_ != nullptr) {
+            std::memcpy(data, data_, write_index_);
+            core::FramePool::deallocate(data_, capacity_);
+        }
+        data_ = data;
+        capacity_ = capacity;
     } else {
         // 将可读数据移动到前面
         size_t readable = readable_bytes();
@@ -0,0 +1,88 @@
+#include "tzzero/utils/cached_clock.h"
+#include <time.h>
+#include <cstdio>
+
+namespace tzzero::utils {
+
+namespace {
+
+thread_local CachedClock* t_current_clock = nullptr;
+
+int64_t read_clock(clockid_t id) {
+    struct timespec ts;
+    ::clock_gettime(id, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+const char kWeekdays[7][4] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+const char kMonths[12][4] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                             "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+unsigned two_digits(int v) { return static_cast<unsigned>(v) % 100; }
+unsigned four_digits(int v) { return static_cast<unsigned>(v) % 10000; }
+
+}  // anonymous namespace
+
+CachedClock::CachedClock()
+    : monotonic_ns_(0)
+    , wall_ns_(0)
+    , rendered_second_(-1)
+{
+    update();
+}
+
+void CachedClock::update() {
+    monotonic_ns_ = read_clock(CLOCK_MONOTONIC);
+    wall_ns_ = read_clock(CLOCK_REALTIME);
+
+    int64_t second = wall_ns_ / 1000000000;
+    if (second != rendered_second_) {
+        render(second);
+    }
+}
+
+void CachedClock::render(int64_t seconds) {
+    rendered_second_ = seconds;
+    time_t t = static_cast<time_t>(seconds);
+
+    // 各字段按格式宽度取模，输出长度固定，不会被截断
+    struct tm gmt;
+    ::gmtime_r(&t, &gmt);
+    snprintf(http_date_, sizeof(http_date_), "%s, %02u %s %04u %02u:%02u:%02u GMT",
+             kWeekdays[gmt.tm_wday % 7], two_digits(gmt.tm_mday), kMonths[gmt.tm_mon % 12],
+             four_digits(gmt.tm_year + 1900), two_digits(gmt.tm_hour), two_digits(gmt.tm_min),
+             two_digits(gmt.tm_sec));
+
+    struct tm local;
+    ::localtime_r(&t, &local);
+    snprintf(local_time_, sizeof(local_time_), "%04u-%02u-%02u %02u:%02u:%02u",
+             four_digits(local.tm_year + 1900), two_digits(local.tm_mon + 1), two_digits(local.tm_mday),
+             two_digits(local.tm_hour), two_digits(local.tm_min), two_digits(local.tm_sec));
+}
+
+void CachedClock::attach() {
+    t_current_clock = this;
+}
+
+void CachedClock::detach() {
+    if (t_current_clock == this) {
+        t_current_clock = nullptr;
+    }
+}
+
+const CachedClock& CachedClock::current() {
+    if (t_current_clock != nullptr) {
+        return *t_current_clock;
+    }
+
+    // 不在事件循环线程中（如工作线程），每次读取时钟，但字符串仍按秒缓存
+    thread_local CachedClock fallback;
+    fallback.update();
+    return fallback;
+}
+
+int64_t CachedClock::read_monotonic_ns() {
+    return read_clock(CLOCK_MONOTONIC);
+}
+
+}  // namespace tzzero::utils
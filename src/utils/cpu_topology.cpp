@@ -0,0 +1,170 @@
+#include "tzzero/utils/cpu_topology.h"
+#include <sched.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+namespace tzzero::utils {
+
+namespace {
+
+// 内核 mempolicy 常量，避免依赖 libnuma
+constexpr int kMpolLocal = 4;
+
+int read_int(const std::string& path, int fallback) {
+    std::ifstream in(path);
+    int value;
+    if (in >> value) {
+        return value;
+    }
+    return fallback;
+}
+
+}  // anonymous namespace
+
+std::vector<int> CpuTopology::parse_cpu_list(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        size_t dash = range.find('-');
+        int first = std::atoi(range.c_str());
+        int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+CpuTopology CpuTopology::detect() {
+    CpuTopology topology;
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (::sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            CPU_SET(cpu, &allowed);
+        }
+    }
+
+    // CPU -> NUMA 节点
+    std::vector<int> cpu_node(CPU_SETSIZE, 0);
+    if (DIR* dir = ::opendir("/sys/devices/system/node")) {
+        while (struct dirent* entry = ::readdir(dir)) {
+            if (strncmp(entry->d_name, "node", 4) != 0 || !isdigit(entry->d_name[4])) {
+                continue;
+            }
+            int node = std::atoi(entry->d_name + 4);
+            std::ifstream in(std::string("/sys/devices/system/node/") + entry->d_name + "/cpulist");
+            std::string list;
+            std::getline(in, list);
+            for (int cpu : parse_cpu_list(list)) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                    cpu_node[cpu] = node;
+                }
+            }
+        }
+        ::closedir(dir);
+    }
+
+    long num_cpus = ::sysconf(_SC_NPROCESSORS_CONF);
+    for (int cpu = 0; cpu < num_cpus && cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed)) {
+            continue;
+        }
+        std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        CpuInfo info;
+        info.cpu = cpu;
+        info.core_id = read_int(base + "core_id", cpu);
+        info.package_id = read_int(base + "physical_package_id", 0);
+        info.numa_node = cpu_node[cpu];
+        topology.cpus_.push_back(info);
+    }
+
+    return topology;
+}
+
+std::vector<int> CpuTopology::physical_cores() const {
+    std::vector<CpuInfo> sorted = cpus_;
+    std::sort(sorted.begin(), sorted.end(), [](const CpuInfo& a, const CpuInfo& b) {
+        if (a.numa_node != b.numa_node) return a.numa_node < b.numa_node;
+        if (a.package_id != b.package_id) return a.package_id < b.package_id;
+        if (a.core_id != b.core_id) return a.core_id < b.core_id;
+        return a.cpu < b.cpu;
+    });
+
+    std::vector<int> result;
+    std::set<std::pair<int, int>> seen;
+    for (const auto& info : sorted) {
+        if (seen.insert({info.package_id, info.core_id}).second) {
+            result.push_back(info.cpu);
+        }
+    }
+    return result;
+}
+
+const CpuInfo* CpuTopology::find(int cpu) const {
+    for (const auto& info : cpus_) {
+        if (info.cpu == cpu) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+int CpuTopology::numa_node_of(int cpu) const {
+    const CpuInfo* info = find(cpu);
+    return info ? info->numa_node : 0;
+}
+
+int CpuTopology::num_numa_nodes() const {
+    std::set<int> nodes;
+    for (const auto& info : cpus_) {
+        nodes.insert(info.numa_node);
+    }
+    return static_cast<int>(nodes.size());
+}
+
+int CpuTopology::num_packages() const {
+    std::set<int> packages;
+    for (const auto& info : cpus_) {
+        packages.insert(info.package_id);
+    }
+    return static_cast<int>(packages.size());
+}
+
+std::string CpuTopology::summary() const {
+    std::ostringstream oss;
+    oss << num_packages() << " package(s), " << num_numa_nodes() << " NUMA node(s), "
+        << physical_cores().size() << " core(s), " << cpus_.size() << " cpu(s)";
+    return oss.str();
+}
+
+bool CpuTopology::pin_current_thread(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+}
+
+bool CpuTopology::prefer_local_memory() {
+#ifdef SYS_set_mempolicy
+    return ::syscall(SYS_set_mempolicy, kMpolLocal, nullptr, 0) == 0;
+#else
+    return false;
+#endif
+}
+
+}  // namespace tzzero::utils
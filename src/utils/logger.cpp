@@ -1,7 +1,7 @@
 #include "tzzero/utils/logger.h"
+#include "tzzero/utils/cached_clock.h"
 #include <iostream>
-#include <iomanip>
-#include <chrono>
+#include <cstdio>
 #include <filesystem>
 
 namespace tzzero::utils {
@@ -70,15 +70,15 @@ std::string Logger::level_to_string(LogLevel level) const {
 }
 
 std::string Logger::get_timestamp() const {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
-    
-    std::ostringstream oss;
-    oss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    oss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    return oss.str();
+    // 事件循环线程读取本轮缓存的时间，秒级部分按秒预渲染
+    const CachedClock& clock = CachedClock::current();
+    int ms = static_cast<int>(clock.wall_ns() / 1000000 % 1000);
+
+    std::string timestamp(clock.local_time());
+    char ms_buf[8];
+    snprintf(ms_buf, sizeof(ms_buf), ".%03d", ms);
+    timestamp += ms_buf;
+    return timestamp;
 }
 
 void Logger::set_output_file(const std::string& filename) {
@@ -1,28 +1,37 @@
 #include "tzzero/utils/thread_pool.h"
+#include <algorithm>
+#include <chrono>
 
 namespace tzzero::utils {
 
-ThreadPool::ThreadPool(size_t num_threads) : stop_flag_(false) {
-    for (size_t i = 0; i < num_threads; ++i) {
-        threads_.emplace_back([this] {
-            while (true) {
-                std::function<void()> task;
+namespace {
 
-                {
-                    std::unique_lock<std::mutex> lock(queue_mutex_);
-                    condition_.wait(lock, [this] { return stop_flag_ || !tasks_.empty(); });
+// Rounds of yielding before an idle worker goes to sleep
+constexpr int kSpinRounds = 32;
 
-                    if (stop_flag_ && tasks_.empty()) {
-                        return;
-                    }
+// Submitter waits: yield first, then back off with short sleeps
+constexpr int kYieldRounds = 64;
+constexpr auto kBackoff = std::chrono::microseconds(50);
 
-                    task = std::move(tasks_.front());
-                    tasks_.pop();
-                }
+thread_local const ThreadPool* t_pool = nullptr;
+thread_local size_t t_worker = 0;
+thread_local size_t t_cursor = std::hash<std::thread::id>{}(std::this_thread::get_id());
 
-                task();
-            }
-        });
+}  // anonymous namespace
+
+ThreadPool::ThreadPool(size_t num_threads, size_t queue_capacity)
+    : stop_flag_(false)
+    , sleeping_(0)
+    , wake_epoch_(0)
+{
+    num_threads = std::max<size_t>(num_threads, 1);
+    workers_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>(queue_capacity));
+    }
+    // Start threads only after every worker exists, since they steal from each other
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_[i]->thread = std::thread([this, i] { worker_loop(i); });
     }
 }
 
@@ -30,19 +39,219 @@ ThreadPool::~ThreadPool() {
     stop();
 }
 
+void ThreadPool::post(Task task) {
+    check_running();
+    enqueue_wait(new TaskNode{std::move(task)});
+}
+
+bool ThreadPool::try_post(Task&& task) {
+    check_running();
+    TaskNode* node = new TaskNode{std::move(task)};
+    if (enqueue(node, true)) {
+        return true;
+    }
+    task = std::move(node->fn);
+    delete node;
+    return false;
+}
+
+void ThreadPool::post_bulk(std::vector<Task> tasks) {
+    check_running();
+    for (auto& task : tasks) {
+        TaskNode* node = new TaskNode{std::move(task)};
+        if (!enqueue(node, false)) {
+            // Let the workers drain what has been queued so far
+            wake(true);
+            enqueue_wait(node);
+        }
+    }
+    wake(true);
+}
+
+size_t ThreadPool::pending() const {
+    size_t total = 0;
+    for (const auto& worker : workers_) {
+        total += worker->local.size() + worker->inbox.size();
+    }
+    return total;
+}
+
+bool ThreadPool::in_worker_thread() const {
+    return t_pool == this;
+}
+
 void ThreadPool::stop() {
     {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
         stop_flag_ = true;
     }
 
-    condition_.notify_all();
+    sleep_cond_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    // Tasks that raced with stop() after the workers exited
+    for (auto& worker : workers_) {
+        while (TaskNode* node = worker->local.pop()) {
+            run(node);
+        }
+        while (TaskNode* node = worker->inbox.pop()) {
+            run(node);
+        }
+    }
+}
+
+void ThreadPool::worker_loop(size_t index) {
+    t_pool = this;
+    t_worker = index;
+
+    int idle_rounds = 0;
+    while (true) {
+        if (TaskNode* node = find_task(index)) {
+            run(node);
+            idle_rounds = 0;
+            continue;
+        }
+
+        if (++idle_rounds < kSpinRounds) {
+            std::this_thread::yield();
+            continue;
+        }
+        idle_rounds = 0;
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleeping_.fetch_add(1, std::memory_order_seq_cst);
+        // Pairs with the fence in wake(): either the submitter sees us sleeping,
+        // or we see its task here
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (has_work()) {
+            sleeping_.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (stop_flag_.load(std::memory_order_relaxed)) {
+            sleeping_.fetch_sub(1, std::memory_order_relaxed);
+            break;
+        }
+
+        uint64_t epoch = wake_epoch_;
+        sleep_cond_.wait(lock, [this, epoch] {
+            return wake_epoch_ != epoch || stop_flag_.load(std::memory_order_relaxed);
+        });
+        sleeping_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    t_pool = nullptr;
+}
+
+ThreadPool::TaskNode* ThreadPool::find_task(size_t index) {
+    Worker& self = *workers_[index];
+    if (TaskNode* node = self.local.pop()) {
+        return node;
+    }
+    if (TaskNode* node = self.inbox.pop()) {
+        return node;
+    }
+
+    size_t n = workers_.size();
+    for (size_t i = 1; i < n; ++i) {
+        Worker& victim = *workers_[(index + i) % n];
+        if (TaskNode* node = victim.local.steal()) {
+            return node;
+        }
+        if (TaskNode* node = victim.inbox.pop()) {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+bool ThreadPool::has_work() const {
+    for (const auto& worker : workers_) {
+        if (!worker->local.empty() || !worker->inbox.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::enqueue(TaskNode* node, bool notify) {
+    bool queued = false;
+    if (t_pool == this) {
+        // Nested task: keep it local, others steal it if they are idle
+        Worker& self = *workers_[t_worker];
+        queued = self.local.push(node) || self.inbox.push(node);
+    } else {
+        size_t n = workers_.size();
+        size_t start = t_cursor++;
+        for (size_t i = 0; i < n && !queued; ++i) {
+            queued = workers_[(start + i) % n]->inbox.push(node);
+        }
+    }
+
+    if (queued && notify) {
+        wake(false);
+    }
+    return queued;
+}
+
+void ThreadPool::enqueue_wait(TaskNode* node) {
+    if (enqueue(node, true)) {
+        return;
+    }
+    if (t_pool == this) {
+        // A worker waiting on its own pool could deadlock; run it here instead
+        run(node);
+        return;
+    }
 
-    for (auto& thread : threads_) {
-        if (thread.joinable()) {
-            thread.join();
+    for (int round = 0; ; ++round) {
+        if (stop_flag_.load(std::memory_order_relaxed)) {
+            // Workers may already have exited, nobody would run it
+            delete node;
+            throw std::runtime_error("Cannot submit task to stopped ThreadPool");
         }
+        if (round < kYieldRounds) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(kBackoff);
+        }
+        if (enqueue(node, true)) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::wake(bool all) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) == 0) {
+        return;
     }
+
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        ++wake_epoch_;
+    }
+    if (all) {
+        sleep_cond_.notify_all();
+    } else {
+        sleep_cond_.notify_one();
+    }
+}
+
+void ThreadPool::check_running() const {
+    // Workers may still fan out while the pool drains
+    if (stop_flag_.load(std::memory_order_relaxed) && t_pool != this) {
+        throw std::runtime_error("Cannot submit task to stopped ThreadPool");
+    }
+}
+
+void ThreadPool::run(TaskNode* node) {
+    std::unique_ptr<TaskNode> guard(node);
+    guard->fn();
 }
 
 } // namespace tzzero::utils
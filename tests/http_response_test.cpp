@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 #include "tzzero/http/http_response.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
 
 using namespace tzzero::http;
 
@@ -174,3 +179,69 @@ TEST_F(HttpResponseTest, StreamId) {
     response.set_stream_id(456);
     EXPECT_EQ(response.get_stream_id(), 456);
 }
+
+TEST_F(HttpResponseTest, FileBody) {
+    char path[] = "/tmp/tzzero_response_XXXXXX";
+    int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::write(fd, "0123456789", 10), 10);
+    ::close(fd);
+
+    EXPECT_TRUE(response.set_file_body(std::string(path)));
+    EXPECT_TRUE(response.has_file_body());
+    EXPECT_EQ(response.get_body_size(), 10);
+    EXPECT_EQ(response.get_header("content-length"), "10");
+
+    std::string buffer = response.to_buffer();
+    EXPECT_TRUE(buffer.ends_with("\r\n\r\n0123456789"));
+
+    // 字符串正文替换文件正文
+    response.set_body("abc");
+    EXPECT_FALSE(response.has_file_body());
+    EXPECT_EQ(response.get_body_size(), 3);
+
+    EXPECT_FALSE(response.set_file_body(std::string("/nonexistent/file")));
+    ::unlink(path);
+}
+
+TEST_F(HttpResponseTest, TruncatedFileBodyThrows) {
+    char path[] = "/tmp/tzzero_response_XXXXXX";
+    int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::write(fd, "short", 5), 5);
+    ::unlink(path);
+
+    // 声明的长度超过文件，不能生成正文短于 content-length 的响应
+    response.set_file_body(fd, 0, 100);
+    std::string buffer = "previous";
+    EXPECT_THROW(response.append_to_buffer(buffer), std::runtime_error);
+    EXPECT_EQ(buffer, "previous");
+}
+
+TEST_F(HttpResponseTest, FileBodyRegionQueued) {
+    char path[] = "/tmp/tzzero_response_XXXXXX";
+    int fd = ::mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::write(fd, "headerBODYtrailer", 17), 17);
+    ::unlink(path);
+
+    response.set_file_body(fd, 6, 4);
+    tzzero::net::OutputQueue queue;
+    response.move_to_queue(queue);
+    EXPECT_FALSE(response.has_file_body());
+
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    int saved_errno = 0;
+    while (!queue.empty()) {
+        ASSERT_GT(queue.write_to(fds[0], &saved_errno), 0);
+    }
+    char buf[1024];
+    ssize_t n = ::read(fds[1], buf, sizeof(buf));
+    ASSERT_GT(n, 0);
+    std::string received(buf, static_cast<size_t>(n));
+    EXPECT_TRUE(received.starts_with("HTTP/1.1 200 OK\r\n"));
+    EXPECT_TRUE(received.ends_with("\r\n\r\nBODY"));
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
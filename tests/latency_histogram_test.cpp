@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include "tzzero/utils/latency_histogram.h"
+
+using namespace tzzero::utils;
+
+TEST(LatencyHistogramTest, Empty) {
+    LatencyHistogram hist;
+    EXPECT_EQ(hist.count(), 0u);
+    EXPECT_EQ(hist.percentile(50), 0u);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram hist;
+    for (uint64_t v = 0; v < 16; ++v) {
+        EXPECT_EQ(LatencyHistogram::bucket_upper_bound(LatencyHistogram::bucket_index(v)), v);
+    }
+}
+
+TEST(LatencyHistogramTest, BucketBoundsContainValue) {
+    const uint64_t values[] = {16, 17, 100, 1000, 123456789, 1ull << 40, UINT64_MAX};
+    for (uint64_t v : values) {
+        int index = LatencyHistogram::bucket_index(v);
+        ASSERT_LT(index, LatencyHistogram::kNumBuckets);
+        uint64_t upper = LatencyHistogram::bucket_upper_bound(index);
+        EXPECT_GE(upper, v);
+        // 相对误差不超过 1/8
+        EXPECT_LE(upper - v, v / 8 + 1);
+    }
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+    LatencyHistogram hist;
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        hist.record(v * 1000);
+    }
+    EXPECT_EQ(hist.count(), 1000u);
+
+    uint64_t p50 = hist.percentile(50);
+    uint64_t p99 = hist.percentile(99);
+    EXPECT_GE(p50, 500000u);
+    EXPECT_LE(p50, 500000u + 500000u / 8);
+    EXPECT_GE(p99, 990000u);
+    EXPECT_LE(p99, 990000u + 990000u / 8);
+    EXPECT_GE(hist.percentile(100), 1000000u);
+
+    hist.reset();
+    EXPECT_EQ(hist.count(), 0u);
+}
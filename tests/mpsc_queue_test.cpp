@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "tzzero/utils/mpsc_queue.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace tzzero::utils;
+
+namespace {
+
+struct Item : MpscNode {
+    Item(int p, int s) : producer(p), seq(s) {}
+    int producer;
+    int seq;
+};
+
+}  // namespace
+
+TEST(MpscQueueTest, EmptyQueue) {
+    MpscQueue<Item> queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.pop(), nullptr);
+}
+
+TEST(MpscQueueTest, FifoOrder) {
+    MpscQueue<Item> queue;
+    std::vector<std::unique_ptr<Item>> items;
+    for (int i = 0; i < 10; ++i) {
+        items.push_back(std::make_unique<Item>(0, i));
+        queue.push(items.back().get());
+    }
+
+    EXPECT_FALSE(queue.empty());
+    for (int i = 0; i < 10; ++i) {
+        Item* item = queue.pop();
+        ASSERT_NE(item, nullptr);
+        EXPECT_EQ(item->seq, i);
+    }
+    EXPECT_EQ(queue.pop(), nullptr);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscQueueTest, ReuseAfterDrain) {
+    MpscQueue<Item> queue;
+    Item a(0, 1), b(0, 2);
+
+    queue.push(&a);
+    EXPECT_EQ(queue.pop(), &a);
+    EXPECT_EQ(queue.pop(), nullptr);
+
+    queue.push(&b);
+    queue.push(&a);
+    EXPECT_EQ(queue.pop(), &b);
+    EXPECT_EQ(queue.pop(), &a);
+    EXPECT_EQ(queue.pop(), nullptr);
+}
+
+TEST(MpscQueueTest, MultipleProducers) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+
+    MpscQueue<Item> queue;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < kPerProducer; ++i) {
+                queue.push(new Item(p, i));
+            }
+        });
+    }
+
+    // 每个生产者内部保持 FIFO
+    std::vector<int> next_seq(kProducers, 0);
+    int received = 0;
+    while (received < kProducers * kPerProducer) {
+        Item* item = queue.pop();
+        if (item == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_EQ(item->seq, next_seq[item->producer]);
+        next_seq[item->producer] = item->seq + 1;
+        ++received;
+        delete item;
+    }
+
+    for (auto& t : producers) {
+        t.join();
+    }
+    EXPECT_EQ(queue.pop(), nullptr);
+}
@@ -0,0 +1,271 @@
+#include <gtest/gtest.h>
+#include "tzzero/net/output_queue.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+
+using namespace tzzero::net;
+
+class OutputQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    }
+
+    void TearDown() override {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    // 读出对端收到的全部数据
+    std::string drain() {
+        std::string out;
+        char buf[65536];
+        ::fcntl(fds[1], F_SETFL, ::fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+        ssize_t n;
+        while ((n = ::read(fds[1], buf, sizeof(buf))) > 0) {
+            out.append(buf, static_cast<size_t>(n));
+        }
+        return out;
+    }
+
+    OutputQueue queue;
+    int fds[2];
+};
+
+TEST_F(OutputQueueTest, InitialState) {
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.size(), 0);
+    EXPECT_EQ(queue.slices(), 0);
+}
+
+TEST_F(OutputQueueTest, CopiesCoalesce) {
+    EXPECT_EQ(queue.append("Hello", 5), 5);
+    EXPECT_EQ(queue.append(", ", 2), 2);
+    EXPECT_EQ(queue.slices(), 1);
+
+    // 接管和静态数据不复制，各自成段
+    EXPECT_EQ(queue.append(std::string("World")), 0);
+    EXPECT_EQ(queue.append_static("!"), 0);
+    EXPECT_EQ(queue.size(), 13);
+    EXPECT_EQ(queue.slices(), 3);
+
+    int saved_errno = 0;
+    EXPECT_EQ(queue.write_to(fds[0], &saved_errno), 13);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(drain(), "Hello, World!");
+}
+
+TEST_F(OutputQueueTest, LargePiecesAreNotCopied) {
+    std::string owned(4096, 'a');
+    auto shared = std::make_shared<const std::string>(8192, 'b');
+    static const std::string kStatic(1024, 'c');
+
+    EXPECT_EQ(queue.append(std::string("head\r\n")), 0);
+    EXPECT_EQ(queue.append(std::move(owned)), 0);
+    EXPECT_EQ(queue.append_shared(shared), 0);
+    EXPECT_EQ(queue.append_static(kStatic), 0);
+    EXPECT_EQ(queue.slices(), 4);
+    EXPECT_EQ(shared.use_count(), 2);
+
+    int saved_errno = 0;
+    EXPECT_EQ(queue.write_to(fds[0], &saved_errno), static_cast<ssize_t>(6 + 4096 + 8192 + 1024));
+    EXPECT_TRUE(queue.empty());
+    // 发完后释放共享数据
+    EXPECT_EQ(shared.use_count(), 1);
+    EXPECT_EQ(drain(), "head\r\n" + std::string(4096, 'a') + std::string(8192, 'b') + kStatic);
+}
+
+TEST_F(OutputQueueTest, OffsetSkipsSentBytes) {
+    auto shared = std::make_shared<const std::string>("0123456789" + std::string(1024, 'x'));
+    queue.append_shared(shared, 10);
+    queue.append(std::string(512, 'y'), 500);
+
+    EXPECT_EQ(queue.size(), 1024 + 12);
+
+    int saved_errno = 0;
+    queue.write_to(fds[0], &saved_errno);
+    EXPECT_EQ(drain(), std::string(1024, 'x') + std::string(12, 'y'));
+}
+
+TEST_F(OutputQueueTest, PartialWriteResumes) {
+    // 填满发送缓冲，写出一部分后从中间继续
+    std::string big(4 * 1024 * 1024, 'z');
+    queue.append(std::string("begin"));
+    queue.append(std::move(big));
+    queue.append_static("end");
+    size_t total = queue.size();
+
+    std::string received;
+    int saved_errno = 0;
+    while (!queue.empty()) {
+        ssize_t n = queue.write_to(fds[0], &saved_errno);
+        if (n < 0) {
+            ASSERT_EQ(saved_errno, EAGAIN);
+        }
+        received += drain();
+    }
+    received += drain();
+    EXPECT_EQ(received.size(), total);
+    EXPECT_EQ(received.substr(0, 5), "begin");
+    EXPECT_EQ(received.substr(received.size() - 3), "end");
+}
+
+TEST_F(OutputQueueTest, GrowsPastInitialRing) {
+    std::string expected;
+    for (int i = 0; i < 100; ++i) {
+        std::string piece(300, static_cast<char>('a' + i % 26));
+        expected += piece;
+        queue.append(std::move(piece));
+    }
+    EXPECT_EQ(queue.slices(), 100);
+
+    int saved_errno = 0;
+    EXPECT_EQ(queue.write_to(fds[0], &saved_errno), static_cast<ssize_t>(expected.size()));
+    EXPECT_EQ(drain(), expected);
+}
+
+TEST_F(OutputQueueTest, AppendQueueKeepsOrder) {
+    OutputQueue other;
+    other.append(std::string(1000, 'b'));
+    other.append_static("tail");
+
+    queue.append(std::string(1000, 'a'));
+    queue.append(std::move(other));
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(queue.size(), 2004);
+
+    OutputQueue moved(std::move(queue));
+    int saved_errno = 0;
+    moved.write_to(fds[0], &saved_errno);
+    EXPECT_EQ(drain(), std::string(1000, 'a') + std::string(1000, 'b') + "tail");
+}
+
+TEST_F(OutputQueueTest, ClearReleasesShared) {
+    auto shared = std::make_shared<const std::string>(1024, 's');
+    queue.append_shared(shared);
+    EXPECT_EQ(shared.use_count(), 2);
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST_F(OutputQueueTest, FileRegionBetweenMemorySlices) {
+    char path[] = "/tmp/tzzero_queue_XXXXXX";
+    int file_fd = ::mkstemp(path);
+    ASSERT_GE(file_fd, 0);
+    std::string content(256 * 1024, 'f');
+    content.replace(0, 5, "start");
+    ASSERT_EQ(::write(file_fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    ::unlink(path);
+
+    auto file = std::make_shared<const OpenFile>(file_fd);
+    queue.append(std::string("head:"));
+    queue.append_file(file, 0, content.size());
+    queue.append_static(":tail");
+    EXPECT_EQ(queue.size(), 5 + content.size() + 5);
+
+    // 内存段在文件段处截止，文件段单独 sendfile
+    int saved_errno = 0;
+    size_t attempted = 0;
+    EXPECT_EQ(queue.write_to(fds[0], &saved_errno, &attempted), 5);
+    EXPECT_EQ(attempted, 5);
+
+    std::string received = drain();
+    while (!queue.empty()) {
+        ssize_t n = queue.write_to(fds[0], &saved_errno);
+        if (n < 0) {
+            ASSERT_EQ(saved_errno, EAGAIN);
+        }
+        received += drain();
+    }
+    EXPECT_EQ(received, "head:" + content + ":tail");
+    // 发完后释放文件
+    EXPECT_EQ(file.use_count(), 1);
+}
+
+TEST_F(OutputQueueTest, TruncatedFileFails) {
+    char path[] = "/tmp/tzzero_queue_XXXXXX";
+    int file_fd = ::mkstemp(path);
+    ASSERT_GE(file_fd, 0);
+    ASSERT_EQ(::write(file_fd, "short", 5), 5);
+    ::unlink(path);
+
+    queue.append_file(std::make_shared<const OpenFile>(file_fd), 0, 100);
+    int saved_errno = 0;
+    EXPECT_EQ(queue.write_to(fds[0], &saved_errno), 5);
+    EXPECT_EQ(queue.write_to(fds[0], &saved_errno), -1);
+    EXPECT_EQ(saved_errno, EIO);
+}
+
+TEST(OutputQueueZeroCopyTest, PinsUntilCompletion) {
+    // 零拷贝只支持 TCP，用回环连接
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    ASSERT_EQ(::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    ASSERT_EQ(::listen(listener, 1), 0);
+    ::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+    int sender = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(::connect(sender, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    int receiver = ::accept(listener, nullptr, nullptr);
+    ::close(listener);
+
+    int one = 1;
+    if (::setsockopt(sender, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) < 0) {
+        ::close(sender);
+        ::close(receiver);
+        GTEST_SKIP() << "SO_ZEROCOPY not supported";
+    }
+
+    ZeroCopyState zerocopy(64 * 1024);
+    auto body = std::make_shared<const std::string>(256 * 1024, 'z');
+    OutputQueue queue;
+    queue.append(std::string("small head"));
+    queue.append_shared(body);
+
+    // 头部普通写出，在大段处截止；大段零拷贝发出后由状态暂存
+    int saved_errno = 0;
+    size_t attempted = 0;
+    EXPECT_EQ(queue.write_to(sender, &saved_errno, &attempted, &zerocopy), 10);
+    EXPECT_EQ(attempted, 10);
+    EXPECT_EQ(zerocopy.sends(), 0);
+    EXPECT_EQ(queue.write_to(sender, &saved_errno, &attempted, &zerocopy),
+              static_cast<ssize_t>(body->size()));
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(zerocopy.sends(), 1);
+    EXPECT_TRUE(zerocopy.outstanding());
+    EXPECT_EQ(zerocopy.pinned(), 1);
+    EXPECT_EQ(body.use_count(), 2);
+
+    std::string received;
+    char buf[65536];
+    while (received.size() < 10 + body->size()) {
+        ssize_t n = ::read(receiver, buf, sizeof(buf));
+        ASSERT_GT(n, 0);
+        received.append(buf, static_cast<size_t>(n));
+    }
+    EXPECT_EQ(received, "small head" + *body);
+
+    // 完成通知以 POLLERR 报告
+    pollfd pfd{sender, 0, 0};
+    ASSERT_EQ(::poll(&pfd, 1, 1000), 1);
+    EXPECT_TRUE(pfd.revents & POLLERR);
+    EXPECT_EQ(zerocopy.read_completions(sender), 1);
+    EXPECT_EQ(zerocopy.completions(), 1);
+    EXPECT_FALSE(zerocopy.outstanding());
+    EXPECT_EQ(zerocopy.pinned(), 0);
+    EXPECT_EQ(body.use_count(), 1);
+
+    ::close(sender);
+    ::close(receiver);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "tzzero/core/task.h"
+#include "tzzero/core/awaitables.h"
+#include "tzzero/core/event_loop.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using namespace tzzero::core;
+
+namespace {
+
+Task<int> add(int a, int b) {
+    co_return a + b;
+}
+
+Task<int> add_twice(int a, int b) {
+    int first = co_await add(a, b);
+    int second = co_await add(first, b);
+    co_return second;
+}
+
+Task<int> fail() {
+    throw std::runtime_error("boom");
+    co_return 0;
+}
+
+Task<void> run_sync(Task<int> task, int* out) {
+    *out = co_await task;
+}
+
+}  // namespace
+
+TEST(TaskTest, LazyAndComposable) {
+    int result = 0;
+    spawn(run_sync(add_twice(1, 2), &result));
+    EXPECT_EQ(result, 5);
+}
+
+TEST(TaskTest, ExceptionPropagatesToAwaiter) {
+    bool caught = false;
+    auto body = [&caught]() -> Task<void> {
+        try {
+            co_await fail();
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+    };
+    spawn(body());
+    EXPECT_TRUE(caught);
+}
+
+TEST(TaskTest, AwaitingEmptyTaskThrows) {
+    bool caught = false;
+    auto body = [&caught]() -> Task<void> {
+        Task<int> empty;
+        try {
+            co_await empty;
+        } catch (const std::logic_error&) {
+            caught = true;
+        }
+    };
+    spawn(body());
+    EXPECT_TRUE(caught);
+}
+
+TEST(TaskTest, FramesReusedOnLoopThread) {
+    EventLoop loop;
+    int result = 0;
+    spawn(run_sync(add(1, 1), &result));
+    uint64_t reused = loop.frame_pool().reused();
+    for (int i = 0; i < 100; ++i) {
+        spawn(run_sync(add(i, 1), &result));
+    }
+    EXPECT_EQ(result, 100);
+    EXPECT_GE(loop.frame_pool().reused() - reused, 200u);
+}
+
+TEST(TaskTest, SleepAndFdReadiness) {
+    EventLoop loop;
+    int efd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    std::vector<int> order;
+
+    auto waiter = [&]() -> Task<void> {
+        uint32_t events = co_await wait_readable(&loop, efd);
+        EXPECT_TRUE(events & Poller::EVENT_READ);
+        order.push_back(2);
+        loop.quit();
+    };
+    auto sleeper = [&]() -> Task<void> {
+        co_await sleep_for(&loop, 0.01);
+        order.push_back(1);
+        uint64_t one = 1;
+        EXPECT_EQ(::write(efd, &one, sizeof(one)), static_cast<ssize_t>(sizeof(one)));
+    };
+    spawn(waiter());
+    spawn(sleeper());
+    loop.loop();
+
+    EXPECT_EQ(order, (std::vector<int>{1, 2}));
+    ::close(efd);
+}
+
+TEST(TaskTest, HopBetweenLoops) {
+    std::atomic<EventLoop*> other{nullptr};
+    std::thread thread([&other]() {
+        EventLoop loop;
+        other = &loop;
+        loop.loop();
+    });
+    while (other.load() == nullptr) {
+        std::this_thread::yield();
+    }
+
+    EventLoop loop;
+    std::thread::id seen;
+    auto body = [&]() -> Task<void> {
+        co_await resume_on(other.load());
+        seen = std::this_thread::get_id();
+        co_await resume_on(&loop);
+        loop.quit();
+    };
+    spawn(body());
+    loop.loop();
+
+    EXPECT_EQ(seen, thread.get_id());
+    other.load()->quit();
+    thread.join();
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "tzzero/utils/thread_pool.h"
+#include "tzzero/utils/work_stealing_deque.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace tzzero::utils;
+
+TEST(WorkStealingDequeTest, OwnerLifoThiefFifo) {
+    WorkStealingDeque<int> deque(8);
+    int values[4] = {0, 1, 2, 3};
+    for (int& v : values) {
+        ASSERT_TRUE(deque.push(&v));
+    }
+
+    EXPECT_EQ(deque.steal(), &values[0]);
+    EXPECT_EQ(deque.pop(), &values[3]);
+    EXPECT_EQ(deque.pop(), &values[2]);
+    EXPECT_EQ(deque.steal(), &values[1]);
+    EXPECT_EQ(deque.pop(), nullptr);
+    EXPECT_EQ(deque.steal(), nullptr);
+}
+
+TEST(WorkStealingDequeTest, BoundedCapacity) {
+    WorkStealingDeque<int> deque(4);
+    int v = 0;
+    for (size_t i = 0; i < deque.capacity(); ++i) {
+        ASSERT_TRUE(deque.push(&v));
+    }
+    EXPECT_FALSE(deque.push(&v));
+    EXPECT_NE(deque.steal(), nullptr);
+    EXPECT_TRUE(deque.push(&v));
+}
+
+TEST(WorkStealingDequeTest, ConcurrentStealNoLossNoDuplicate) {
+    constexpr int kItems = 100000;
+    WorkStealingDeque<int> deque(1024);
+    std::vector<int> items(kItems);
+    std::vector<std::atomic<int>> seen(kItems);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&]() {
+            while (!done.load() || !deque.empty()) {
+                if (int* item = deque.steal()) {
+                    seen[item - items.data()].fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < kItems; ++i) {
+        while (!deque.push(&items[i])) {
+            if (int* item = deque.pop()) {
+                seen[item - items.data()].fetch_add(1);
+            }
+        }
+    }
+    while (int* item = deque.pop()) {
+        seen[item - items.data()].fetch_add(1);
+    }
+    done = true;
+    for (auto& t : thieves) {
+        t.join();
+    }
+
+    for (int i = 0; i < kItems; ++i) {
+        ASSERT_EQ(seen[i].load(), 1) << "item " << i;
+    }
+}
+
+TEST(ThreadPoolTest, SubmitReturnsResult) {
+    ThreadPool pool(2);
+    auto future = pool.submit([](int a, int b) { return a + b; }, 2, 3);
+    EXPECT_EQ(future.get(), 5);
+}
+
+TEST(ThreadPoolTest, PostFromManyThreads) {
+    constexpr int kThreads = 8;
+    constexpr int kTasks = 10000;
+    std::atomic<int> count{0};
+    {
+        ThreadPool pool(4, 64);
+        std::vector<std::thread> submitters;
+        for (int t = 0; t < kThreads; ++t) {
+            submitters.emplace_back([&]() {
+                for (int i = 0; i < kTasks; ++i) {
+                    pool.post([&count]() { count.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+        for (auto& t : submitters) {
+            t.join();
+        }
+    }
+    EXPECT_EQ(count.load(), kThreads * kTasks);
+}
+
+TEST(ThreadPoolTest, NestedPostAndBulk) {
+    std::atomic<int> count{0};
+    {
+        ThreadPool pool(3, 16);
+        std::vector<ThreadPool::Task> tasks;
+        for (int i = 0; i < 100; ++i) {
+            tasks.push_back([&pool, &count]() {
+                EXPECT_TRUE(pool.in_worker_thread());
+                for (int j = 0; j < 50; ++j) {
+                    // 本地队列满时在当前线程执行，不会死锁
+                    pool.post([&count]() { count.fetch_add(1); });
+                }
+            });
+        }
+        pool.post_bulk(std::move(tasks));
+        EXPECT_FALSE(pool.in_worker_thread());
+    }
+    EXPECT_EQ(count.load(), 100 * 50);
+}
+
+TEST(ThreadPoolTest, TryPostReportsFullQueues) {
+    ThreadPool pool(1, 2);
+    std::atomic<bool> release{false};
+    pool.post([&release]() {
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (pool.pending() != 0) {
+        std::this_thread::yield();
+    }
+
+    int accepted = 0;
+    while (pool.try_post([]() {})) {
+        ++accepted;
+    }
+    EXPECT_EQ(accepted, 2);
+    release = true;
+}
+
+TEST(ThreadPoolTest, PostAfterStopThrows) {
+    ThreadPool pool(1);
+    pool.stop();
+    EXPECT_THROW(pool.post([]() {}), std::runtime_error);
+    EXPECT_THROW(pool.submit([]() { return 1; }), std::runtime_error);
+}
@@ -0,0 +1,333 @@
+#include "tzzero/net/tcp_server.h"
+#include "tzzero/core/event_loop.h"
+#include "tzzero/utils/buffer.h"
+#include "tzzero/utils/logger.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <csignal>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 建连风暴基准：多个客户端线程不停地建连后立即以 RST 关闭（SO_LINGER 0，
+// 不占 TIME_WAIT 端口），比较主线程逐个转交与按批转交两种模式下的
+// accept / 关闭速率，I/O 线程每个连接收到的跨线程任务数和唤醒数，
+// 以及每个连接的堆分配次数；另测一次性关闭大量连接的速率和建连到首字节的延迟
+
+// 全进程的 operator new 计数，客户端线程建连不分配，差值即服务端的分配
+static std::atomic<uint64_t> g_allocations{0};
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+using namespace tzzero;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int clients = 8;
+    int io_threads = 4;
+    int duration = 3;
+    int burst = 5000;
+    int port = 18380;
+};
+
+void print_usage(const char* program) {
+    std::cout << "TZZero Accept Rate Benchmark\n\n"
+              << "Usage: " << program << " [OPTIONS]\n"
+              << "Options:\n"
+              << "  -c, --clients NUM       Connecting client threads (default: 8)\n"
+              << "  -t, --threads NUM       Server I/O threads (default: 4)\n"
+              << "  -d, --duration SEC      Seconds per mode (default: 3)\n"
+              << "  -n, --burst NUM         Connections in the close burst / first-byte runs (default: 5000)\n"
+              << "  -P, --port PORT         First listen port (default: 18380)\n"
+              << "  -h, --help              Show this help message\n"
+              << std::endl;
+}
+
+void client(int port, const std::atomic<bool>& stop) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    linger abort_close{1, 0};
+
+    while (!stop.load(std::memory_order_relaxed)) {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        ::setsockopt(fd, SOL_SOCKET, SO_LINGER, &abort_close, sizeof(abort_close));
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            ::close(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        ::close(fd);
+    }
+}
+
+void run(bool batch, int port, const Options& opts) {
+    std::atomic<core::EventLoop*> loop_ptr{nullptr};
+    std::mutex loops_mutex;
+    std::set<core::EventLoop*> io_loops;
+    uint64_t accepted = 0;
+    uint64_t closed = 0;
+    uint64_t tasks = 0;
+    uint64_t wakeups = 0;
+    uint64_t allocations = 0;
+    uint64_t window_conns = 0;
+    std::atomic<uint64_t> established{0};
+
+    std::thread server_thread([&]() {
+        core::EventLoop loop;
+        net::TcpServer server(&loop, "127.0.0.1", static_cast<uint16_t>(port), "AcceptBench");
+        server.set_thread_num(opts.io_threads);
+        server.set_batch_accept(batch);
+        server.set_connection_callback([&](const net::TcpConnectionPtr& conn) {
+            established.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(loops_mutex);
+            io_loops.insert(conn->get_loop());
+        });
+        server.start();
+        loop_ptr = &loop;
+        loop.loop();
+
+        // 各 I/O 线程仍在运行，此时读取的是近似值
+        std::lock_guard<std::mutex> lock(loops_mutex);
+        for (core::EventLoop* io_loop : io_loops) {
+            accepted += io_loop->stats().connections_total();
+            closed += io_loop->stats().connections_total()
+                    - static_cast<uint64_t>(io_loop->stats().connections());
+            tasks += io_loop->wakeups() + io_loop->wakeups_saved();
+            wakeups += io_loop->wakeups();
+        }
+    });
+    while (loop_ptr.load() == nullptr) {
+        std::this_thread::yield();
+    }
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> clients;
+    for (int i = 0; i < opts.clients; ++i) {
+        clients.emplace_back(client, port, std::cref(stop));
+    }
+    // 预热：池和连接表在最初一批连接中填满，之后的稳态才是要看的
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    uint64_t allocations_before = g_allocations.load();
+    uint64_t established_before = established.load();
+    std::this_thread::sleep_for(std::chrono::seconds(opts.duration));
+    stop = true;
+    for (auto& t : clients) {
+        t.join();
+    }
+    // 等主线程把最后一批交出去
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    allocations = g_allocations.load() - allocations_before;
+    window_conns = established.load() - established_before;
+    loop_ptr.load()->quit();
+    server_thread.join();
+
+    double per_conn = accepted > 0 ? 1.0 / static_cast<double>(accepted) : 0.0;
+    char line[160];
+    snprintf(line, sizeof(line), "%-9s %10llu %12.0f %12.0f %12.3f %12.3f %12.2f\n",
+             batch ? "batched" : "per-conn", static_cast<unsigned long long>(accepted),
+             accepted / static_cast<double>(opts.duration), closed / static_cast<double>(opts.duration),
+             tasks * per_conn, wakeups * per_conn,
+             window_conns > 0 ? allocations / static_cast<double>(window_conns) : 0.0);
+    std::cout << line << std::flush;
+}
+
+// 关闭风暴：先建立 burst 个连接，再一次性全部 RST 关闭，
+// 计时到服务端所有I/O线程的连接数归零
+void run_close_burst(int port, const Options& opts) {
+    std::atomic<core::EventLoop*> loop_ptr{nullptr};
+    std::atomic<net::TcpServer*> server_ptr{nullptr};
+    std::thread server_thread([&]() {
+        core::EventLoop loop;
+        net::TcpServer server(&loop, "127.0.0.1", static_cast<uint16_t>(port), "CloseBench");
+        server.set_thread_num(opts.io_threads);
+        server.start();
+        server_ptr = &server;
+        loop_ptr = &loop;
+        loop.loop();
+    });
+    while (loop_ptr.load() == nullptr) {
+        std::this_thread::yield();
+    }
+    net::TcpServer* server = server_ptr.load();
+    auto live = [server]() {
+        int64_t total = 0;
+        for (int64_t count : server->connection_counts()) {
+            total += count;
+        }
+        return total;
+    };
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    linger abort_close{1, 0};
+    std::vector<int> fds;
+    for (int i = 0; i < opts.burst; ++i) {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        ::setsockopt(fd, SOL_SOCKET, SO_LINGER, &abort_close, sizeof(abort_close));
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            ::close(fd);
+            continue;
+        }
+        fds.push_back(fd);
+    }
+    while (live() < static_cast<int64_t>(fds.size())) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto start = Clock::now();
+    for (int fd : fds) {
+        ::close(fd);
+    }
+    while (live() > 0) {
+        std::this_thread::yield();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    loop_ptr.load()->quit();
+    server_thread.join();
+
+    char line[160];
+    snprintf(line, sizeof(line), "close burst: %zu connections in %.1f ms, %.0f closes/s\n",
+             fds.size(), seconds * 1000.0, fds.size() / seconds);
+    std::cout << line << std::flush;
+}
+
+// 建连到首字节：单个客户端依次建连、发 1 字节、等服务端回显后 RST 关闭，
+// 统计从 connect 开始到收到回显的时间，包含服务端 accept、创建连接和首次读写
+void run_first_byte(int port, const Options& opts) {
+    std::atomic<core::EventLoop*> loop_ptr{nullptr};
+    std::thread server_thread([&]() {
+        core::EventLoop loop;
+        net::TcpServer server(&loop, "127.0.0.1", static_cast<uint16_t>(port), "FirstByteBench");
+        server.set_thread_num(opts.io_threads);
+        server.set_message_callback([](const net::TcpConnectionPtr& conn, utils::Buffer& buf) {
+            conn->send(buf);
+        });
+        server.start();
+        loop_ptr = &loop;
+        loop.loop();
+    });
+    while (loop_ptr.load() == nullptr) {
+        std::this_thread::yield();
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    linger abort_close{1, 0};
+    std::vector<int64_t> samples;
+    samples.reserve(opts.burst);
+    for (int i = 0; i < opts.burst; ++i) {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        ::setsockopt(fd, SOL_SOCKET, SO_LINGER, &abort_close, sizeof(abort_close));
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        auto start = Clock::now();
+        char byte = 'x';
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+            ::write(fd, &byte, 1) == 1 && ::read(fd, &byte, 1) == 1) {
+            samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - start).count());
+        }
+        ::close(fd);
+    }
+
+    loop_ptr.load()->quit();
+    server_thread.join();
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double p) {
+        return samples.empty() ? 0.0 : samples[static_cast<size_t>(p / 100.0 * (samples.size() - 1))] / 1000.0;
+    };
+    char line[160];
+    snprintf(line, sizeof(line), "accept to first byte: %zu connections, p50 %.1f us, p99 %.1f us\n",
+             samples.size(), at(50), at(99));
+    std::cout << line << std::flush;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+
+    struct option long_options[] = {
+        {"clients", required_argument, 0, 'c'},
+        {"threads", required_argument, 0, 't'},
+        {"duration", required_argument, 0, 'd'},
+        {"burst", required_argument, 0, 'n'},
+        {"port", required_argument, 0, 'P'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "c:t:d:n:P:h", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'c': opts.clients = std::stoi(optarg); break;
+            case 't': opts.io_threads = std::stoi(optarg); break;
+            case 'd': opts.duration = std::stoi(optarg); break;
+            case 'n': opts.burst = std::stoi(optarg); break;
+            case 'P': opts.port = std::stoi(optarg); break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    // 客户端以 RST 关闭，服务端的读错误日志在这里没有意义
+    utils::Logger::instance().set_level(utils::LogLevel::FATAL);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "\n=== " << opts.clients << " client thread(s) connecting, "
+              << opts.io_threads << " I/O thread(s) ===\n"
+              << "tasks/conn and wakeups/conn are cross-thread tasks queued to, and eventfd\n"
+              << "wakeups of, the I/O loops (closing a connection adds one task of its own);\n"
+              << "allocs/conn counts heap allocations after a short warm-up\n\n";
+    std::cout << "mode         accepts    accepts/s     closes/s   tasks/conn wakeups/conn  allocs/conn\n";
+
+    run(false, opts.port, opts);
+    run(true, opts.port + 1, opts);
+    std::cout << std::endl;
+    run_close_burst(opts.port + 2, opts);
+    run_first_byte(opts.port + 3, opts);
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,320 @@
+#include "tzzero/net/tcp_server.h"
+#include "tzzero/core/event_loop.h"
+#include "tzzero/utils/buffer.h"
+#include "tzzero/utils/logger.h"
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <csignal>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 连接分配不均基准：单个客户端按固定速率建连，每 N 个连接中有一个长连接
+// （N 默认等于 I/O 线程数，与轮询周期重合），长连接周期性发送 ping，
+// 服务端每个 ping 消耗一定 CPU 后回显。周期采样各 I/O 线程的连接数，
+// 比较各分配策略下的 max/mean 连接数比和 ping 往返延迟
+
+using namespace tzzero;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int io_threads = 4;
+    int duration = 3;
+    int rate = 2;          // 每毫秒新建连接数
+    int short_ms = 20;
+    int long_ms = 2000;
+    int long_every = 0;    // 0 表示等于 io_threads
+    int ping_ms = 20;
+    int work_us = 10;
+    int port = 18280;
+};
+
+void print_usage(const char* program) {
+    std::cout << "TZZero Connection Balance Benchmark\n\n"
+              << "Usage: " << program << " [OPTIONS]\n"
+              << "Options:\n"
+              << "  -t, --threads NUM       Server I/O threads (default: 4)\n"
+              << "  -d, --duration SEC      Seconds per strategy (default: 3)\n"
+              << "  -r, --rate NUM          New connections per ms (default: 2)\n"
+              << "  -s, --short MS          Short connection lifetime (default: 20)\n"
+              << "  -l, --long MS           Long connection lifetime (default: 2000)\n"
+              << "  -e, --long-every NUM    One long connection every NUM (default: threads)\n"
+              << "  -i, --ping MS           Ping interval on long connections (default: 20)\n"
+              << "  -w, --work US           Server CPU time per ping (default: 10)\n"
+              << "  -P, --port PORT         First listen port (default: 18280)\n"
+              << "  -h, --help              Show this help message\n"
+              << std::endl;
+}
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count();
+}
+
+void burn_cpu(int us) {
+    auto until = Clock::now() + std::chrono::microseconds(us);
+    while (Clock::now() < until) {
+    }
+}
+
+int connect_to(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+// 先读掉未读的回显再关闭，避免内核发送 RST
+void close_conn(int fd) {
+    char sink[512];
+    while (::read(fd, sink, sizeof(sink)) > 0) {
+    }
+    ::close(fd);
+}
+
+double percentile(std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1));
+    return sorted[index] / 1000.0;
+}
+
+struct ClientConn {
+    int64_t deadline_ns;
+    int64_t next_ping_ns;   // 0 表示短连接，不发 ping
+};
+
+struct Result {
+    double mean_ratio = 0;   // 采样的 max/mean 平均值
+    double worst_ratio = 0;
+    std::vector<int64_t> final_counts;
+    std::vector<int64_t> latencies;
+};
+
+// 单线程客户端：建连、到期关闭、长连接定时 ping 并读取回显
+void run_client(int port, const Options& opts, net::TcpServer* server, Result* result) {
+    int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    std::unordered_map<int, ClientConn> conns;
+    int long_every = opts.long_every > 0 ? opts.long_every : opts.io_threads;
+
+    int64_t start = now_ns();
+    int64_t end = start + opts.duration * 1000000000LL;
+    int64_t warmup = start + opts.duration * 1000000000LL / 3;
+    int64_t next_sample = warmup;
+    uint64_t seq = 0;
+    int samples = 0;
+    epoll_event events[256];
+
+    while (now_ns() < end) {
+        int64_t now = now_ns();
+
+        for (int i = 0; i < opts.rate; ++i) {
+            int fd = connect_to(port);
+            if (fd < 0) {
+                continue;
+            }
+            bool is_long = seq++ % static_cast<uint64_t>(long_every) == 0;
+            conns[fd] = ClientConn{now + (is_long ? opts.long_ms : opts.short_ms) * 1000000LL,
+                                   is_long ? now + opts.ping_ms * 1000000LL : 0};
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            ::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+        }
+
+        for (auto it = conns.begin(); it != conns.end();) {
+            if (it->second.deadline_ns <= now) {
+                close_conn(it->first);
+                it = conns.erase(it);
+                continue;
+            }
+            if (it->second.next_ping_ns != 0 && it->second.next_ping_ns <= now) {
+                int64_t stamp = now_ns();
+                ssize_t n = ::write(it->first, &stamp, sizeof(stamp));
+                (void)n;
+                it->second.next_ping_ns = now + opts.ping_ms * 1000000LL;
+            }
+            ++it;
+        }
+
+        int n = ::epoll_wait(epfd, events, 256, 1);
+        for (int i = 0; i < n; ++i) {
+            int64_t stamps[64];
+            ssize_t got = ::read(events[i].data.fd, stamps, sizeof(stamps));
+            int64_t received = now_ns();
+            for (ssize_t k = 0; k + static_cast<ssize_t>(sizeof(int64_t)) <= got; k += sizeof(int64_t)) {
+                if (received > warmup) {
+                    result->latencies.push_back(received - stamps[k / sizeof(int64_t)]);
+                }
+            }
+        }
+
+        if (now >= next_sample) {
+            next_sample = now + 10 * 1000000LL;
+            std::vector<int64_t> counts = server->connection_counts();
+            int64_t total = 0;
+            int64_t max_count = 0;
+            for (int64_t count : counts) {
+                total += count;
+                max_count = std::max(max_count, count);
+            }
+            if (total > 0) {
+                double ratio = static_cast<double>(max_count) * counts.size() / total;
+                result->mean_ratio += ratio;
+                result->worst_ratio = std::max(result->worst_ratio, ratio);
+                ++samples;
+            }
+            result->final_counts = counts;
+        }
+    }
+
+    if (samples > 0) {
+        result->mean_ratio /= samples;
+    }
+    for (auto& item : conns) {
+        close_conn(item.first);
+    }
+    ::close(epfd);
+
+    // 等服务端关完所有连接再退出事件循环
+    auto give_up = Clock::now() + std::chrono::seconds(5);
+    while (Clock::now() < give_up) {
+        int64_t total = 0;
+        for (int64_t count : server->connection_counts()) {
+            total += count;
+        }
+        if (total == 0) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+void run(const char* label, net::LoadBalance strategy, int port, const Options& opts) {
+    std::atomic<core::EventLoop*> loop_ptr{nullptr};
+    std::atomic<net::TcpServer*> server_ptr{nullptr};
+    std::thread server_thread([&]() {
+        core::EventLoop loop;
+        net::TcpServer server(&loop, "127.0.0.1", static_cast<uint16_t>(port), "BalanceBench");
+        server.set_thread_num(opts.io_threads);
+        server.set_load_balance(strategy);
+        int work_us = opts.work_us;
+        server.set_message_callback([work_us](const net::TcpConnectionPtr& conn, utils::Buffer& buf) {
+            size_t pings = buf.readable_bytes() / sizeof(int64_t);
+            for (size_t i = 0; i < pings; ++i) {
+                burn_cpu(work_us);
+            }
+            conn->send(buf.peek(), pings * sizeof(int64_t));
+            buf.retrieve(pings * sizeof(int64_t));
+        });
+        server.start();
+        server_ptr = &server;
+        loop_ptr = &loop;
+        loop.loop();
+    });
+    while (loop_ptr.load() == nullptr) {
+        std::this_thread::yield();
+    }
+
+    Result result;
+    run_client(port, opts, server_ptr.load(), &result);
+    loop_ptr.load()->quit();
+    server_thread.join();
+
+    std::sort(result.latencies.begin(), result.latencies.end());
+    std::string counts;
+    for (int64_t count : result.final_counts) {
+        counts += (counts.empty() ? "" : "/") + std::to_string(count);
+    }
+
+    char line[256];
+    snprintf(line, sizeof(line), "%-8s %10.2f %10.2f %10.1f %10.1f   %s\n",
+             label, result.mean_ratio, result.worst_ratio,
+             percentile(result.latencies, 50), percentile(result.latencies, 99), counts.c_str());
+    std::cout << line << std::flush;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+
+    struct option long_options[] = {
+        {"threads", required_argument, 0, 't'},
+        {"duration", required_argument, 0, 'd'},
+        {"rate", required_argument, 0, 'r'},
+        {"short", required_argument, 0, 's'},
+        {"long", required_argument, 0, 'l'},
+        {"long-every", required_argument, 0, 'e'},
+        {"ping", required_argument, 0, 'i'},
+        {"work", required_argument, 0, 'w'},
+        {"port", required_argument, 0, 'P'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "t:d:r:s:l:e:i:w:P:h", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 't': opts.io_threads = std::stoi(optarg); break;
+            case 'd': opts.duration = std::stoi(optarg); break;
+            case 'r': opts.rate = std::stoi(optarg); break;
+            case 's': opts.short_ms = std::stoi(optarg); break;
+            case 'l': opts.long_ms = std::stoi(optarg); break;
+            case 'e': opts.long_every = std::stoi(optarg); break;
+            case 'i': opts.ping_ms = std::stoi(optarg); break;
+            case 'w': opts.work_us = std::stoi(optarg); break;
+            case 'P': opts.port = std::stoi(optarg); break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    utils::Logger::instance().set_level(utils::LogLevel::WARN);
+    signal(SIGPIPE, SIG_IGN);
+
+    int long_every = opts.long_every > 0 ? opts.long_every : opts.io_threads;
+    std::cout << "\n=== " << opts.io_threads << " I/O threads, " << opts.rate
+              << " conn/ms, 1 in " << long_every << " lives " << opts.long_ms
+              << "ms (others " << opts.short_ms << "ms) ===\n"
+              << "max/mean: busiest loop's connections over the average (1.00 = even)\n"
+              << "hash: all connections come from 127.0.0.1 and share one loop\n\n";
+    std::cout << "strategy   max/mean      worst  ping p50   ping p99   final per-loop connections\n";
+
+    run("rr", net::LoadBalance::ROUND_ROBIN, opts.port, opts);
+    run("least", net::LoadBalance::LEAST_CONNECTIONS, opts.port + 1, opts);
+    run("p2c", net::LoadBalance::POWER_OF_TWO, opts.port + 2, opts);
+    run("hash", net::LoadBalance::PEER_HASH, opts.port + 3, opts);
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,281 @@
+#include "tzzero/core/epoll_poller.h"
+#include "tzzero/core/event_loop.h"
+#include "tzzero/utils/logger.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 事件分发微基准：N 个常就绪的 eventfd 注册到 epoll，比较每个事件的处理开销
+//
+// - epoll_wait:  只调用 epoll_wait，作为内核开销的基线
+// - map+copy:    旧实现，按 fd 查 unordered_map，把 std::function 拷进 PollEvent 再调用
+// - flat table:  EpollPoller，data.ptr 直接指向处理器表，分发时不拷贝
+//
+// 后两者减去基线即为用户态分发开销
+
+using namespace tzzero;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Callback = std::function<void(int, uint32_t)>;
+
+constexpr int kReservedFds = 64;
+
+struct Options {
+    std::vector<int> fd_counts = {1000, 10000, 100000};
+    uint64_t events_per_run = 5000000;
+};
+
+// 旧实现中的就绪事件
+struct LegacyEvent {
+    int fd;
+    uint32_t events;
+    Callback callback;
+};
+
+void print_usage(const char* program) {
+    std::cout << "TZZero Event Dispatch Benchmark\n\n"
+              << "Usage: " << program << " [OPTIONS]\n"
+              << "Options:\n"
+              << "  -n, --fds LIST          Registered fd counts, comma separated (default: 1000,10000,100000)\n"
+              << "  -e, --events NUM        Events dispatched per measurement (default: 5000000)\n"
+              << "  -h, --help              Show this help message\n"
+              << std::endl;
+}
+
+int raise_fd_limit(int needed) {
+    struct rlimit rl;
+    if (::getrlimit(RLIMIT_NOFILE, &rl) != 0) {
+        return -1;
+    }
+    if (rl.rlim_cur < static_cast<rlim_t>(needed)) {
+        rl.rlim_cur = std::min<rlim_t>(rl.rlim_max, needed);
+        ::setrlimit(RLIMIT_NOFILE, &rl);
+    }
+    return static_cast<int>(rl.rlim_cur);
+}
+
+// 创建 N 个常就绪的 eventfd（写入后不读取，水平触发下一直可读）
+// 受 fd 上限约束时少建一些，给 epoll fd 等留出余量
+std::vector<int> create_ready_fds(int count, int limit) {
+    count = std::min(count, limit - kReservedFds);
+    std::vector<int> fds;
+    fds.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        int fd = ::eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0) {
+            break;
+        }
+        fds.push_back(fd);
+    }
+    return fds;
+}
+
+template<typename PollOnce>
+double measure(uint64_t target_events, PollOnce&& poll_once) {
+    // 预热：让各自的事件数组扩容到位
+    for (int i = 0; i < 3; ++i) {
+        poll_once();
+    }
+
+    uint64_t total = 0;
+    auto start = Clock::now();
+    while (total < target_events) {
+        uint64_t n = poll_once();
+        if (n == 0) {
+            std::cerr << "poll returned no events, aborting measurement" << std::endl;
+            break;
+        }
+        total += n;
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return total > 0 ? elapsed / static_cast<double>(total) : 0.0;
+}
+
+double bench_raw(const std::vector<int>& fds, uint64_t target_events) {
+    int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    for (int fd : fds) {
+        epoll_event ev;
+        ev.events = EPOLLIN | EPOLLPRI;
+        ev.data.fd = fd;
+        ::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    std::vector<epoll_event> events(fds.size());
+    uint64_t sink = 0;
+    double ns = measure(target_events, [&]() -> uint64_t {
+        int n = ::epoll_wait(epfd, events.data(), static_cast<int>(events.size()), 0);
+        for (int i = 0; i < n; ++i) {
+            sink += static_cast<uint64_t>(events[i].data.fd);
+        }
+        return n > 0 ? n : 0;
+    });
+
+    ::close(epfd);
+    if (sink == 0) {
+        std::cerr << "unexpected: no events" << std::endl;
+    }
+    return ns;
+}
+
+double bench_legacy(const std::vector<int>& fds, uint64_t target_events) {
+    int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    std::unordered_map<int, Callback> callbacks;
+    uint64_t handled = 0;
+
+    for (int fd : fds) {
+        epoll_event ev;
+        ev.events = EPOLLIN | EPOLLPRI;
+        ev.data.fd = fd;
+        ::epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+        callbacks[fd] = [&handled](int, uint32_t) { ++handled; };
+    }
+
+    std::vector<epoll_event> events(fds.size());
+    std::vector<LegacyEvent> active;
+    double ns = measure(target_events, [&]() -> uint64_t {
+        active.clear();
+        int n = ::epoll_wait(epfd, events.data(), static_cast<int>(events.size()), 0);
+        active.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            auto it = callbacks.find(fd);
+            if (it != callbacks.end()) {
+                LegacyEvent event;
+                event.fd = fd;
+                event.events = core::Poller::EVENT_READ;
+                event.callback = it->second;
+                active.push_back(event);
+            }
+        }
+        for (const auto& event : active) {
+            if (event.callback) {
+                event.callback(event.fd, event.events);
+            }
+        }
+        return n > 0 ? n : 0;
+    });
+
+    ::close(epfd);
+    return ns;
+}
+
+double bench_flat(core::EventLoop* loop, const std::vector<int>& fds, uint64_t target_events) {
+    core::EpollPoller poller(loop);
+    uint64_t handled = 0;
+
+    for (int fd : fds) {
+        poller.add_fd(fd, core::Poller::EVENT_READ, [&handled](int, uint32_t) { ++handled; });
+    }
+
+    std::vector<core::PollEvent> active;
+    double ns = measure(target_events, [&]() -> uint64_t {
+        active.clear();
+        int n = poller.poll(0, active);
+        for (const auto& event : active) {
+            event.dispatch();
+        }
+        return n > 0 ? n : 0;
+    });
+
+    for (int fd : fds) {
+        poller.remove_fd(fd);
+    }
+    return ns;
+}
+
+std::vector<int> parse_list(const std::string& text) {
+    std::vector<int> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            values.push_back(std::stoi(item));
+        }
+    }
+    return values;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+
+    struct option long_options[] = {
+        {"fds", required_argument, 0, 'n'},
+        {"events", required_argument, 0, 'e'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "n:e:h", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'n':
+                opts.fd_counts = parse_list(optarg);
+                break;
+            case 'e':
+                opts.events_per_run = std::stoull(optarg);
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    utils::Logger::instance().set_level(utils::LogLevel::WARN);
+
+    int max_fds = 0;
+    for (int n : opts.fd_counts) {
+        max_fds = std::max(max_fds, n);
+    }
+    int limit = raise_fd_limit(max_fds + kReservedFds);
+
+    core::EventLoop loop;
+
+    std::cout << "\n=== Event dispatch cost (ns/event, all fds ready, level-triggered) ===\n\n";
+    std::cout << "     fds   epoll_wait     map+copy   flat table   dispatch(map)  dispatch(flat)\n";
+
+    for (int requested : opts.fd_counts) {
+        std::vector<int> fds = create_ready_fds(requested, limit);
+        if (static_cast<int>(fds.size()) < requested) {
+            std::cerr << "Warning: only " << fds.size() << " of " << requested
+                      << " fds created (RLIMIT_NOFILE=" << limit << ")" << std::endl;
+        }
+        if (fds.empty()) {
+            continue;
+        }
+
+        double raw = bench_raw(fds, opts.events_per_run);
+        double legacy = bench_legacy(fds, opts.events_per_run);
+        double flat = bench_flat(&loop, fds, opts.events_per_run);
+
+        char line[160];
+        snprintf(line, sizeof(line), "%8zu %12.1f %12.1f %12.1f %14.1f %15.1f\n",
+                 fds.size(), raw, legacy, flat, legacy - raw, flat - raw);
+        std::cout << line;
+
+        for (int fd : fds) {
+            ::close(fd);
+        }
+    }
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,242 @@
+#include "tzzero/http/http_server.h"
+#include "tzzero/core/event_loop.h"
+#include "tzzero/utils/logger.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 慢处理器隔离基准：同一 I/O 线程上混合快请求 /fast 和占用 CPU 的慢请求 /slow，
+// 比较处理器在 I/O 线程内执行与转交工作线程池两种模式下快请求的延迟分布
+
+using namespace tzzero;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int fast_clients = 4;
+    int slow_clients = 2;
+    int slow_ms = 5;
+    int io_threads = 1;
+    int workers = 2;
+    int duration = 3;
+    int port = 18180;
+};
+
+void print_usage(const char* program) {
+    std::cout << "TZZero Handler Offload Benchmark\n\n"
+              << "Usage: " << program << " [OPTIONS]\n"
+              << "Options:\n"
+              << "  -f, --fast NUM          Clients requesting /fast (default: 4)\n"
+              << "  -s, --slow NUM          Clients requesting /slow (default: 2)\n"
+              << "  -w, --work MS           CPU time per /slow request in ms (default: 5)\n"
+              << "  -i, --io-threads NUM    Server I/O threads (default: 1)\n"
+              << "  -p, --workers NUM       Worker pool threads in offload mode (default: 2)\n"
+              << "  -d, --duration SEC      Seconds per mode (default: 3)\n"
+              << "  -P, --port PORT         First listen port (default: 18180)\n"
+              << "  -h, --help              Show this help message\n"
+              << std::endl;
+}
+
+void burn_cpu(int ms) {
+    auto until = Clock::now() + std::chrono::milliseconds(ms);
+    volatile uint64_t sink = 0;
+    while (Clock::now() < until) {
+        for (int i = 0; i < 1000; ++i) {
+            sink = sink + i;
+        }
+    }
+}
+
+int connect_to(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return fd;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ::close(fd);
+    return -1;
+}
+
+// 阻塞读取一个完整响应（头部 + Content-Length 长度的响应体）
+bool read_response(int fd, std::string& buf) {
+    char chunk[4096];
+    while (true) {
+        size_t header_end = buf.find("\r\n\r\n");
+        if (header_end != std::string::npos) {
+            size_t length = 0;
+            size_t pos = buf.find("Content-Length: ");
+            if (pos != std::string::npos && pos < header_end) {
+                length = std::stoul(buf.substr(pos + 16));
+            }
+            size_t total = header_end + 4 + length;
+            if (buf.size() >= total) {
+                buf.erase(0, total);
+                return true;
+            }
+        }
+        ssize_t n = ::read(fd, chunk, sizeof(chunk));
+        if (n <= 0) {
+            return false;
+        }
+        buf.append(chunk, static_cast<size_t>(n));
+    }
+}
+
+// 在 path 上循环请求直到 stop，记录每次往返延迟（纳秒）
+void client(int port, const std::string& path, const std::atomic<bool>& stop,
+            std::vector<int64_t>* samples) {
+    int fd = connect_to(port);
+    if (fd < 0) {
+        return;
+    }
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    std::string buf;
+    while (!stop.load(std::memory_order_relaxed)) {
+        auto start = Clock::now();
+        if (::write(fd, request.data(), request.size()) != static_cast<ssize_t>(request.size()) ||
+            !read_response(fd, buf)) {
+            break;
+        }
+        if (samples) {
+            samples->push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - start).count());
+        }
+    }
+    ::close(fd);
+}
+
+double percentile(std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1));
+    return sorted[index] / 1000.0;
+}
+
+void run(bool offload, int port, const Options& opts) {
+    std::atomic<core::EventLoop*> loop_ptr{nullptr};
+    std::thread server_thread([&]() {
+        core::EventLoop loop;
+        http::HttpServer server(&loop, "127.0.0.1", static_cast<uint16_t>(port), "OffloadBench");
+        server.set_thread_num(opts.io_threads);
+        int slow_ms = opts.slow_ms;
+        server.set_http_callback([slow_ms](const http::HttpRequest& req, http::HttpResponse& resp) {
+            if (req.get_path() == "/slow") {
+                burn_cpu(slow_ms);
+            }
+            resp.set_body("ok");
+        });
+        if (offload) {
+            server.set_worker_threads(opts.workers);
+            server.set_offload_predicate([](const http::HttpRequest& req) {
+                return req.get_path() == "/slow";
+            });
+        }
+        server.start();
+        loop_ptr = &loop;
+        loop.loop();
+    });
+    while (loop_ptr.load() == nullptr) {
+        std::this_thread::yield();
+    }
+
+    std::atomic<bool> stop{false};
+    std::vector<std::vector<int64_t>> samples(opts.fast_clients);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < opts.slow_clients; ++i) {
+        clients.emplace_back(client, port, "/slow", std::cref(stop), nullptr);
+    }
+    for (int i = 0; i < opts.fast_clients; ++i) {
+        clients.emplace_back(client, port, "/fast", std::cref(stop), &samples[i]);
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(opts.duration));
+    stop = true;
+    for (auto& t : clients) {
+        t.join();
+    }
+    loop_ptr.load()->quit();
+    server_thread.join();
+
+    std::vector<int64_t> all;
+    for (auto& s : samples) {
+        all.insert(all.end(), s.begin(), s.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    char line[160];
+    snprintf(line, sizeof(line), "%-8s %10zu %10.1f %10.1f %10.1f %10.1f\n",
+             offload ? "offload" : "inline", all.size(), all.size() / double(opts.duration),
+             percentile(all, 50), percentile(all, 99), percentile(all, 99.9));
+    std::cout << line;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+
+    struct option long_options[] = {
+        {"fast", required_argument, 0, 'f'},
+        {"slow", required_argument, 0, 's'},
+        {"work", required_argument, 0, 'w'},
+        {"io-threads", required_argument, 0, 'i'},
+        {"workers", required_argument, 0, 'p'},
+        {"duration", required_argument, 0, 'd'},
+        {"port", required_argument, 0, 'P'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "f:s:w:i:p:d:P:h", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'f': opts.fast_clients = std::stoi(optarg); break;
+            case 's': opts.slow_clients = std::stoi(optarg); break;
+            case 'w': opts.slow_ms = std::stoi(optarg); break;
+            case 'i': opts.io_threads = std::stoi(optarg); break;
+            case 'p': opts.workers = std::stoi(optarg); break;
+            case 'd': opts.duration = std::stoi(optarg); break;
+            case 'P': opts.port = std::stoi(optarg); break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    utils::Logger::instance().set_level(utils::LogLevel::WARN);
+
+    std::cout << "\n=== /fast latency with " << opts.slow_clients << " client(s) hitting /slow ("
+              << opts.slow_ms << "ms CPU), " << opts.io_threads << " I/O thread(s) ===\n\n";
+    std::cout << "mode       requests      req/s    p50(us)    p99(us)  p99.9(us)\n";
+
+    run(false, opts.port, opts);
+    run(true, opts.port + 1, opts);
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,284 @@
+#include "tzzero/http/http_server.h"
+#include "tzzero/core/event_loop.h"
+#include "tzzero/utils/logger.h"
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <csignal>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// HTTP 流水线基准：每个 keep-alive 连接一次写出 depth 个 GET 请求，收齐全部响应后
+// 发下一批。服务端在一个事件循环中处理，统计每秒请求数、每个请求的发送调用数
+// （同一次读到的请求的响应合并成一次写，随深度降到约 1/depth）和每个请求的循环轮数
+
+using namespace tzzero;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int connections = 8;
+    int duration = 2;
+    int body_size = 64;
+    size_t max_pipelined = 128;
+    std::vector<int> depths{1, 16, 64};
+    int port = 18880;
+};
+
+void print_usage(const char* program) {
+    std::cout << "TZZero HTTP Pipelining Benchmark\n\n"
+              << "Usage: " << program << " [OPTIONS]\n"
+              << "Options:\n"
+              << "  -c, --connections NUM   Client connections (default: 8)\n"
+              << "  -d, --duration SEC      Seconds per depth (default: 2)\n"
+              << "  -s, --size BYTES        Response body size (default: 64)\n"
+              << "  -p, --depths LIST       Comma-separated pipeline depths (default: 1,16,64)\n"
+              << "  -m, --max-pipelined NUM Server cap on pending responses, 0 = unlimited (default: 128)\n"
+              << "  -P, --port PORT         First listen port (default: 18880)\n"
+              << "  -h, --help              Show this help message\n"
+              << std::endl;
+}
+
+std::vector<int> parse_depths(const std::string& list) {
+    std::vector<int> depths;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            depths.push_back(std::stoi(item));
+        }
+    }
+    return depths;
+}
+
+int connect_to(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+// 客户端一侧的响应解析：只解析头部里的 content-length，正文只计数
+struct ClientConn {
+    int fd;
+    std::string head;
+    size_t body_left = 0;
+    bool in_body = false;
+    int outstanding = 0;   // 本批还没收到的响应
+
+    // 返回本次数据中完成的响应数
+    int feed(const char* data, size_t len) {
+        int done = 0;
+        while (len > 0) {
+            if (in_body) {
+                size_t take = std::min(len, body_left);
+                body_left -= take;
+                data += take;
+                len -= take;
+                if (body_left == 0) {
+                    in_body = false;
+                    ++done;
+                }
+                continue;
+            }
+            size_t before = head.size();
+            head.append(data, std::min<size_t>(len, 4096));
+            size_t end = head.find("\r\n\r\n");
+            if (end == std::string::npos) {
+                data += head.size() - before;
+                len -= head.size() - before;
+                continue;
+            }
+            size_t consumed = end + 4 - before;
+            size_t pos = head.find("content-length: ");
+            body_left = pos == std::string::npos ? 0 : std::strtoull(head.c_str() + pos + 16, nullptr, 10);
+            head.clear();
+            data += consumed;
+            len -= consumed;
+            in_body = true;
+            if (body_left == 0) {
+                in_body = false;
+                ++done;
+            }
+        }
+        return done;
+    }
+};
+
+// 单线程客户端，返回完成的请求数
+uint64_t run_client(int port, const Options& opts, int depth) {
+    std::string batch;
+    for (int i = 0; i < depth; ++i) {
+        batch += "GET /pipeline HTTP/1.1\r\nHost: bench\r\n\r\n";
+    }
+
+    int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<ClientConn> conns;
+    for (int i = 0; i < opts.connections; ++i) {
+        int fd = connect_to(port);
+        if (fd >= 0) {
+            conns.emplace_back();
+            conns.back().fd = fd;
+        }
+    }
+    for (size_t i = 0; i < conns.size(); ++i) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        ::epoll_ctl(epfd, EPOLL_CTL_ADD, conns[i].fd, &ev);
+        conns[i].outstanding = depth;
+        ssize_t n = ::write(conns[i].fd, batch.data(), batch.size());
+        (void)n;
+    }
+
+    // 到时后不再发新的一批，收完在途的响应再关闭
+    uint64_t requests = 0;
+    auto end = Clock::now() + std::chrono::seconds(opts.duration);
+    auto give_up = end + std::chrono::seconds(2);
+    size_t active = conns.size();
+    std::vector<char> sink(1 << 16);
+    epoll_event events[64];
+    while (active > 0 && Clock::now() < give_up) {
+        int n = ::epoll_wait(epfd, events, 64, 100);
+        bool more = Clock::now() < end;
+        for (int i = 0; i < n; ++i) {
+            ClientConn& conn = conns[events[i].data.u64];
+            ssize_t got;
+            while ((got = ::read(conn.fd, sink.data(), sink.size())) > 0) {
+                conn.outstanding -= conn.feed(sink.data(), static_cast<size_t>(got));
+            }
+            if (conn.outstanding == 0) {
+                requests += static_cast<uint64_t>(depth);
+                if (!more) {
+                    conn.outstanding = -1;
+                    --active;
+                    continue;
+                }
+                conn.outstanding = depth;
+                ssize_t w = ::write(conn.fd, batch.data(), batch.size());
+                (void)w;
+            }
+        }
+    }
+
+    for (ClientConn& conn : conns) {
+        ::close(conn.fd);
+    }
+    ::close(epfd);
+    return requests;
+}
+
+void run(int depth, int port, const Options& opts) {
+    std::string body(static_cast<size_t>(opts.body_size), 'p');
+
+    std::atomic<core::EventLoop*> loop_ptr{nullptr};
+    std::thread server_thread([&]() {
+        core::EventLoop loop;
+        http::HttpServer server(&loop, "127.0.0.1", static_cast<uint16_t>(port), "PipelineBench");
+        // 连接由这个循环自己处理，统计直接取它的
+        server.set_thread_num(0);
+        server.set_max_pipelined_requests(opts.max_pipelined);
+        server.set_http_callback([&body](const http::HttpRequest&, http::HttpResponse& resp) {
+            resp.set_header("content-type", "text/plain");
+            resp.set_body(body);
+        });
+        server.start();
+        loop_ptr = &loop;
+        loop.loop();
+    });
+    while (loop_ptr.load() == nullptr) {
+        std::this_thread::yield();
+    }
+
+    const core::LoopStats& stats = loop_ptr.load()->stats();
+    uint64_t writes_before = stats.output_syscalls();
+    uint64_t requests_before = stats.requests();
+    uint64_t iterations_before = stats.iterations();
+    auto start = Clock::now();
+    uint64_t requests = run_client(port, opts, depth);
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    uint64_t writes = stats.output_syscalls() - writes_before;
+    uint64_t handled = stats.requests() - requests_before;
+    uint64_t iterations = stats.iterations() - iterations_before;
+    loop_ptr.load()->quit();
+    server_thread.join();
+
+    double per = handled > 0 ? static_cast<double>(handled) : 1.0;
+    char line[200];
+    snprintf(line, sizeof(line), "%5d %12.0f %12.3f %12.3f\n",
+             depth, requests / seconds, writes / per, iterations / per);
+    std::cout << line << std::flush;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+
+    struct option long_options[] = {
+        {"connections", required_argument, 0, 'c'},
+        {"duration", required_argument, 0, 'd'},
+        {"size", required_argument, 0, 's'},
+        {"depths", required_argument, 0, 'p'},
+        {"max-pipelined", required_argument, 0, 'm'},
+        {"port", required_argument, 0, 'P'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "c:d:s:p:m:P:h", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'c': opts.connections = std::stoi(optarg); break;
+            case 'd': opts.duration = std::stoi(optarg); break;
+            case 's': opts.body_size = std::stoi(optarg); break;
+            case 'p': opts.depths = parse_depths(optarg); break;
+            case 'm': opts.max_pipelined = std::stoul(optarg); break;
+            case 'P': opts.port = std::stoi(optarg); break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    utils::Logger::instance().set_level(utils::LogLevel::WARN);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "\n=== " << opts.connections << " keep-alive connections, " << opts.body_size
+              << "-byte bodies, one event loop, pending cap " << opts.max_pipelined << " ===\n"
+              << "writes: write/writev calls per request; iters: event loop iterations per request\n\n";
+    std::cout << "depth        req/s   writes/req    iters/req\n";
+
+    int port = opts.port;
+    for (int depth : opts.depths) {
+        run(depth, port++, opts);
+    }
+    std::cout << std::endl;
+    return 0;
+}
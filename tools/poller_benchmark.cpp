@@ -0,0 +1,331 @@
+#include "tzzero/core/event_loop.h"
+#include "tzzero/http/http_server.h"
+#include "tzzero/utils/logger.h"
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 轮询器 A/B 基准：同一进程内分别以 epoll / io_uring 启动 HttpServer，
+// 用大量 keep-alive 连接持续发送请求，比较吞吐和 CPU 消耗
+
+using namespace tzzero;
+
+namespace {
+
+const char kRequest[] = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+struct Options {
+    int connections = 10000;
+    int duration = 5;
+    int server_threads = 1;
+    int client_threads = 2;
+    uint16_t port = 18080;
+    std::string mode = "both";
+    bool edge_triggered = false;
+};
+
+struct ClientConn {
+    int fd;
+    std::string buffer;
+};
+
+void print_usage(const char* program) {
+    std::cout << "TZZero Poller A/B Benchmark\n\n"
+              << "Usage: " << program << " [OPTIONS]\n"
+              << "Options:\n"
+              << "  -c, --connections NUM   Keep-alive connections (default: 10000)\n"
+              << "  -d, --duration SEC      Duration per poller in seconds (default: 5)\n"
+              << "  -t, --threads NUM       Server I/O threads (default: 1)\n"
+              << "  -T, --client-threads N  Client threads (default: 2)\n"
+              << "  -p, --port PORT         Base listen port (default: 18080)\n"
+              << "  -m, --mode MODE         epoll | io_uring | both (default: both)\n"
+              << "  -E, --edge              Edge-triggered connections\n"
+              << "  -h, --help              Show this help message\n"
+              << std::endl;
+}
+
+void raise_fd_limit(int needed) {
+    struct rlimit rl;
+    if (::getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < static_cast<rlim_t>(needed)) {
+        rl.rlim_cur = std::min<rlim_t>(rl.rlim_max, needed);
+        ::setrlimit(RLIMIT_NOFILE, &rl);
+        if (rl.rlim_cur < static_cast<rlim_t>(needed)) {
+            std::cerr << "Warning: RLIMIT_NOFILE capped at " << rl.rlim_cur
+                      << ", need " << needed << std::endl;
+        }
+    }
+}
+
+double cpu_seconds() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6
+         + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+int connect_to(uint16_t port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (::connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+// 从缓冲区中取出完整响应，返回取出的个数
+int consume_responses(std::string& buffer) {
+    int count = 0;
+    size_t pos = 0;
+    while (true) {
+        size_t header_end = buffer.find("\r\n\r\n", pos);
+        if (header_end == std::string::npos) {
+            break;
+        }
+
+        size_t body_len = 0;
+        size_t cl = buffer.find("content-length: ", pos);
+        if (cl != std::string::npos && cl < header_end) {
+            body_len = std::strtoul(buffer.c_str() + cl + 16, nullptr, 10);
+        }
+
+        size_t end = header_end + 4 + body_len;
+        if (end > buffer.size()) {
+            break;
+        }
+        pos = end;
+        ++count;
+    }
+    buffer.erase(0, pos);
+    return count;
+}
+
+void client_thread(uint16_t port, int num_conns, std::atomic<bool>& running,
+                   std::atomic<bool>& measuring, std::atomic<uint64_t>& completed) {
+    int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<ClientConn> conns;
+    conns.reserve(num_conns);
+
+    for (int i = 0; i < num_conns; ++i) {
+        int fd = connect_to(port);
+        if (fd < 0) {
+            std::cerr << "connect failed after " << i << " connections: " << strerror(errno) << std::endl;
+            break;
+        }
+        conns.push_back({fd, {}});
+    }
+
+    for (size_t i = 0; i < conns.size(); ++i) {
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        ::epoll_ctl(epfd, EPOLL_CTL_ADD, conns[i].fd, &ev);
+        ssize_t n = ::write(conns[i].fd, kRequest, sizeof(kRequest) - 1);
+        (void)n;
+    }
+
+    std::vector<epoll_event> events(1024);
+    char buf[16384];
+    uint64_t local = 0;
+
+    while (running.load(std::memory_order_relaxed)) {
+        int n = ::epoll_wait(epfd, events.data(), static_cast<int>(events.size()), 100);
+        for (int i = 0; i < n; ++i) {
+            ClientConn& conn = conns[events[i].data.u64];
+            ssize_t r = ::read(conn.fd, buf, sizeof(buf));
+            if (r <= 0) {
+                continue;
+            }
+            conn.buffer.append(buf, r);
+            int done = consume_responses(conn.buffer);
+            for (int k = 0; k < done; ++k) {
+                ssize_t w = ::write(conn.fd, kRequest, sizeof(kRequest) - 1);
+                (void)w;
+            }
+            if (measuring.load(std::memory_order_relaxed)) {
+                local += done;
+            }
+        }
+        if (local >= 1024) {
+            completed.fetch_add(local, std::memory_order_relaxed);
+            local = 0;
+        }
+    }
+    completed.fetch_add(local, std::memory_order_relaxed);
+
+    for (const auto& conn : conns) {
+        ::close(conn.fd);
+    }
+    ::close(epfd);
+}
+
+void run(const std::string& poller, const Options& opts, uint16_t port) {
+    ::setenv("TZZERO_POLLER", poller.c_str(), 1);
+
+    std::atomic<core::EventLoop*> server_loop{nullptr};
+    std::thread server_thread([&]() {
+        core::EventLoop loop;
+        http::HttpServer server(&loop, "127.0.0.1", port, "PollerBench");
+        server.set_thread_num(opts.server_threads);
+        server.enable_edge_triggered(opts.edge_triggered);
+        server.set_http_callback([](const http::HttpRequest&, http::HttpResponse& resp) {
+            resp.set_text_content_type();
+            resp.set_body("hello");
+        });
+        server.start();
+        server_loop = &loop;
+        loop.loop();
+    });
+
+    while (server_loop.load() == nullptr) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::atomic<bool> running{true};
+    std::atomic<bool> measuring{false};
+    std::atomic<uint64_t> completed{0};
+    std::vector<std::thread> clients;
+    int per_thread = opts.connections / opts.client_threads;
+    for (int i = 0; i < opts.client_threads; ++i) {
+        int n = (i == opts.client_threads - 1) ? opts.connections - per_thread * i : per_thread;
+        clients.emplace_back(client_thread, port, n, std::ref(running),
+                             std::ref(measuring), std::ref(completed));
+    }
+
+    // 等待连接建立并预热
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    double cpu_start = cpu_seconds();
+    auto start = std::chrono::steady_clock::now();
+    measuring = true;
+    std::this_thread::sleep_for(std::chrono::seconds(opts.duration));
+    measuring = false;
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double cpu = cpu_seconds() - cpu_start;
+
+    running = false;
+    for (auto& t : clients) {
+        t.join();
+    }
+
+    // 让服务器处理完连接关闭
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    server_loop.load()->quit();
+    server_thread.join();
+
+    uint64_t total = completed.load();
+    std::cout << poller << ":\n"
+              << "  Requests:      " << total << "\n"
+              << "  Requests/sec:  " << static_cast<uint64_t>(total / elapsed) << "\n"
+              << "  CPU seconds:   " << cpu << " (client + server)\n"
+              << "  CPU us/req:    " << (total ? cpu * 1e6 / total : 0.0) << "\n\n";
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+
+    struct option long_options[] = {
+        {"connections", required_argument, 0, 'c'},
+        {"duration", required_argument, 0, 'd'},
+        {"threads", required_argument, 0, 't'},
+        {"client-threads", required_argument, 0, 'T'},
+        {"port", required_argument, 0, 'p'},
+        {"mode", required_argument, 0, 'm'},
+        {"edge", no_argument, 0, 'E'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "c:d:t:T:p:m:Eh", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'c':
+                opts.connections = std::stoi(optarg);
+                break;
+            case 'd':
+                opts.duration = std::stoi(optarg);
+                break;
+            case 't':
+                opts.server_threads = std::stoi(optarg);
+                break;
+            case 'T':
+                opts.client_threads = std::max(1, std::stoi(optarg));
+                break;
+            case 'p':
+                opts.port = static_cast<uint16_t>(std::stoi(optarg));
+                break;
+            case 'm':
+                opts.mode = optarg;
+                break;
+            case 'E':
+                opts.edge_triggered = true;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    utils::Logger::instance().set_level(utils::LogLevel::WARN);
+    raise_fd_limit(opts.connections * 2 + 1024);
+
+    std::vector<std::string> pollers;
+    if (opts.mode == "both") {
+        pollers = {"epoll", "io_uring"};
+    } else {
+        pollers = {opts.mode};
+    }
+
+#ifndef ENABLE_IO_URING
+    for (const auto& p : pollers) {
+        if (p == "io_uring") {
+            std::cerr << "Built without ENABLE_IO_URING, io_uring run will use epoll.\n"
+                      << "Reconfigure with -DENABLE_IO_URING=ON for a real A/B comparison.\n\n";
+        }
+    }
+#endif
+
+    std::cout << "\n=== Poller A/B: " << opts.connections << " keep-alive connections, "
+              << opts.server_threads << " server thread(s), " << opts.duration << "s"
+              << (opts.edge_triggered ? ", edge-triggered" : "") << " ===\n\n";
+
+    uint16_t port = opts.port;
+    for (const auto& p : pollers) {
+        run(p, opts, port++);
+    }
+
+    return 0;
+}
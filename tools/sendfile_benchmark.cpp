@@ -0,0 +1,280 @@
+#include "tzzero/http/http_server.h"
+#include "tzzero/core/event_loop.h"
+#include "tzzero/utils/logger.h"
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <csignal>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 大文件下载基准：多个 keep-alive 连接反复 GET 同一个文件，对比两种正文：
+//   read     - 每个请求把整个文件读进字符串作为正文（原来 examples/static_files 的做法）
+//   sendfile - 文件区间正文，响应头之后由 sendfile 从页缓存直接发出
+// 统计吞吐和运行期间进程常驻内存（RSS）比启动前的峰值增长
+
+using namespace tzzero;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int connections = 8;
+    int duration = 3;
+    int size_kb = 8192;
+    int port = 18680;
+};
+
+void print_usage(const char* program) {
+    std::cout << "TZZero File Body Benchmark\n\n"
+              << "Usage: " << program << " [OPTIONS]\n"
+              << "Options:\n"
+              << "  -c, --connections NUM   Client connections (default: 8)\n"
+              << "  -d, --duration SEC      Seconds per mode (default: 3)\n"
+              << "  -s, --size KB           File size in KB (default: 8192)\n"
+              << "  -P, --port PORT         First listen port (default: 18680)\n"
+              << "  -h, --help              Show this help message\n"
+              << std::endl;
+}
+
+size_t resident_bytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t total = 0;
+    size_t resident = 0;
+    statm >> total >> resident;
+    return resident * static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+int connect_to(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+// 客户端一侧的响应解析：只解析头部里的 content-length，正文只计数
+struct ClientConn {
+    int fd;
+    std::string head;
+    size_t body_left = 0;
+    bool in_body = false;
+
+    // 返回本次数据中完成的响应数
+    int feed(const char* data, size_t len) {
+        int done = 0;
+        while (len > 0) {
+            if (in_body) {
+                size_t take = std::min(len, body_left);
+                body_left -= take;
+                data += take;
+                len -= take;
+                if (body_left == 0) {
+                    in_body = false;
+                    ++done;
+                }
+                continue;
+            }
+            size_t before = head.size();
+            head.append(data, std::min<size_t>(len, 4096));
+            size_t end = head.find("\r\n\r\n");
+            if (end == std::string::npos) {
+                data += head.size() - before;
+                len -= head.size() - before;
+                continue;
+            }
+            size_t consumed = end + 4 - before;
+            size_t pos = head.find("content-length: ");
+            body_left = pos == std::string::npos ? 0 : std::strtoull(head.c_str() + pos + 16, nullptr, 10);
+            head.clear();
+            data += consumed;
+            len -= consumed;
+            in_body = true;
+            if (body_left == 0) {
+                in_body = false;
+                ++done;
+            }
+        }
+        return done;
+    }
+};
+
+struct Result {
+    uint64_t responses = 0;
+    double seconds = 0;
+    size_t peak_rss = 0;
+};
+
+Result run_client(int port, const Options& opts) {
+    static const char kRequest[] = "GET /file HTTP/1.1\r\nHost: bench\r\n\r\n";
+    Result result;
+    int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<ClientConn> conns;
+    for (int i = 0; i < opts.connections; ++i) {
+        int fd = connect_to(port);
+        if (fd >= 0) {
+            conns.emplace_back();
+            conns.back().fd = fd;
+        }
+    }
+    for (size_t i = 0; i < conns.size(); ++i) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        ::epoll_ctl(epfd, EPOLL_CTL_ADD, conns[i].fd, &ev);
+        ssize_t n = ::write(conns[i].fd, kRequest, sizeof(kRequest) - 1);
+        (void)n;
+    }
+
+    std::vector<char> sink(1 << 20);
+    epoll_event events[64];
+    auto start = Clock::now();
+    auto end = start + std::chrono::seconds(opts.duration);
+    auto next_sample = start;
+    while (Clock::now() < end) {
+        int n = ::epoll_wait(epfd, events, 64, 100);
+        for (int i = 0; i < n; ++i) {
+            ClientConn& conn = conns[events[i].data.u64];
+            ssize_t got;
+            while ((got = ::read(conn.fd, sink.data(), sink.size())) > 0) {
+                int done = conn.feed(sink.data(), static_cast<size_t>(got));
+                result.responses += static_cast<uint64_t>(done);
+                for (int k = 0; k < done; ++k) {
+                    ssize_t w = ::write(conn.fd, kRequest, sizeof(kRequest) - 1);
+                    (void)w;
+                }
+            }
+        }
+        auto now = Clock::now();
+        if (now >= next_sample) {
+            result.peak_rss = std::max(result.peak_rss, resident_bytes());
+            next_sample = now + std::chrono::milliseconds(10);
+        }
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (ClientConn& conn : conns) {
+        ::close(conn.fd);
+    }
+    ::close(epfd);
+    return result;
+}
+
+void run(const char* label, bool use_sendfile, const std::string& path, int port, const Options& opts) {
+    std::atomic<core::EventLoop*> loop_ptr{nullptr};
+    std::thread server_thread([&]() {
+        core::EventLoop loop;
+        http::HttpServer server(&loop, "127.0.0.1", static_cast<uint16_t>(port), "FileBench");
+        server.set_thread_num(1);
+        server.set_http_callback([use_sendfile, path](const http::HttpRequest&, http::HttpResponse& resp) {
+            resp.set_header("content-type", "application/octet-stream");
+            if (use_sendfile) {
+                resp.set_file_body(path);
+            } else {
+                std::ifstream file(path, std::ios::binary);
+                std::ostringstream oss;
+                oss << file.rdbuf();
+                resp.set_body(oss.str());
+            }
+        });
+        server.start();
+        loop_ptr = &loop;
+        loop.loop();
+    });
+    while (loop_ptr.load() == nullptr) {
+        std::this_thread::yield();
+    }
+
+    size_t baseline = resident_bytes();
+    Result result = run_client(port, opts);
+    loop_ptr.load()->quit();
+    server_thread.join();
+
+    double mb = static_cast<double>(opts.size_kb) / 1024.0;
+    double growth = result.peak_rss > baseline ? (result.peak_rss - baseline) / (1024.0 * 1024.0) : 0.0;
+    char line[200];
+    snprintf(line, sizeof(line), "%-9s %10.1f %10.1f %14.1f %14.2f\n",
+             label, result.responses / result.seconds, result.responses * mb / result.seconds,
+             growth, growth / opts.connections);
+    std::cout << line << std::flush;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+
+    struct option long_options[] = {
+        {"connections", required_argument, 0, 'c'},
+        {"duration", required_argument, 0, 'd'},
+        {"size", required_argument, 0, 's'},
+        {"port", required_argument, 0, 'P'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "c:d:s:P:h", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'c': opts.connections = std::stoi(optarg); break;
+            case 'd': opts.duration = std::stoi(optarg); break;
+            case 's': opts.size_kb = std::stoi(optarg); break;
+            case 'P': opts.port = std::stoi(optarg); break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    utils::Logger::instance().set_level(utils::LogLevel::WARN);
+    signal(SIGPIPE, SIG_IGN);
+
+    // 测试文件，预先读一遍进页缓存
+    char path[] = "/tmp/tzzero_sendfile_XXXXXX";
+    int fd = ::mkstemp(path);
+    if (fd < 0) {
+        std::cerr << "mkstemp failed: " << strerror(errno) << std::endl;
+        return 1;
+    }
+    std::string chunk(1024, 'f');
+    for (int i = 0; i < opts.size_kb; ++i) {
+        ssize_t n = ::write(fd, chunk.data(), chunk.size());
+        (void)n;
+    }
+    ::close(fd);
+
+    std::cout << "\n=== " << opts.connections << " keep-alive connections downloading a "
+              << opts.size_kb << "KB file, one I/O thread ===\n"
+              << "RSS growth: peak resident memory above the level before the run\n\n";
+    std::cout << "mode           resp/s       MB/s  RSS growth MB  MB/connection\n";
+
+    run("read", false, path, opts.port, opts);
+    run("sendfile", true, path, opts.port + 1, opts);
+    std::cout << std::endl;
+
+    ::unlink(path);
+    return 0;
+}
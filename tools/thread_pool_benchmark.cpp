@@ -0,0 +1,237 @@
+#include "tzzero/utils/thread_pool.h"
+#include <getopt.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 线程池吞吐基准：多个提交线程向线程池投递空任务，测量从开始提交到全部执行完的耗时
+//
+// - legacy submit:  旧实现，单个 mutex + condition_variable 保护的 std::queue，
+//                   每个任务一个 shared_ptr<packaged_task> 和 future
+// - submit:         工作窃取池，仍返回 future
+// - post:           工作窃取池，无 future
+// - post_bulk:      工作窃取池，每批 64 个任务一次提交
+
+using namespace tzzero;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kBulkSize = 64;
+
+struct Options {
+    std::vector<int> submitters = {1, 8, 64};
+    int threads = 4;
+    int tasks = 1000000;
+};
+
+// 旧实现，保留用于对比
+class LegacyThreadPool {
+public:
+    explicit LegacyThreadPool(size_t num_threads) : stop_flag_(false) {
+        for (size_t i = 0; i < num_threads; ++i) {
+            threads_.emplace_back([this] {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(queue_mutex_);
+                        condition_.wait(lock, [this] { return stop_flag_ || !tasks_.empty(); });
+                        if (stop_flag_ && tasks_.empty()) {
+                            return;
+                        }
+                        task = std::move(tasks_.front());
+                        tasks_.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~LegacyThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            stop_flag_ = true;
+        }
+        condition_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    template<typename F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<F>> {
+        using return_type = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<return_type()>>(std::forward<F>(f));
+        std::future<return_type> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            tasks_.emplace([task]() { (*task)(); });
+        }
+        condition_.notify_one();
+        return result;
+    }
+
+private:
+    std::vector<std::thread> threads_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex queue_mutex_;
+    std::condition_variable condition_;
+    bool stop_flag_;
+};
+
+void print_usage(const char* program) {
+    std::cout << "TZZero Thread Pool Benchmark\n\n"
+              << "Usage: " << program << " [OPTIONS]\n"
+              << "Options:\n"
+              << "  -s, --submitters LIST   Submitter thread counts, comma separated (default: 1,8,64)\n"
+              << "  -t, --threads NUM       Pool worker threads (default: 4)\n"
+              << "  -n, --tasks NUM         Total tasks per run (default: 1000000)\n"
+              << "  -h, --help              Show this help message\n"
+              << std::endl;
+}
+
+std::vector<int> parse_list(const std::string& text) {
+    std::vector<int> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            values.push_back(std::stoi(item));
+        }
+    }
+    return values;
+}
+
+// 启动 submitters 个线程各自执行 submit_range(数量)，等待 done 达到 total，返回每任务纳秒数
+template<typename SubmitRange>
+double measure(int submitters, int total, std::atomic<int>& done, SubmitRange&& submit_range) {
+    done.store(0);
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    int per_thread = total / submitters;
+
+    for (int i = 0; i < submitters; ++i) {
+        int count = per_thread + (i < total % submitters ? 1 : 0);
+        threads.emplace_back([&go, &submit_range, count]() {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            submit_range(count);
+        });
+    }
+
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    while (done.load(std::memory_order_acquire) < total) {
+        std::this_thread::yield();
+    }
+    double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return elapsed / total;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+
+    struct option long_options[] = {
+        {"submitters", required_argument, 0, 's'},
+        {"threads", required_argument, 0, 't'},
+        {"tasks", required_argument, 0, 'n'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "s:t:n:h", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 's':
+                opts.submitters = parse_list(optarg);
+                break;
+            case 't':
+                opts.threads = std::stoi(optarg);
+                break;
+            case 'n':
+                opts.tasks = std::stoi(optarg);
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    std::cout << "\n=== Thread pool throughput: " << opts.tasks << " empty tasks, "
+              << opts.threads << " workers (ns/task) ===\n\n";
+    std::cout << "submitters  legacy submit       submit         post    post_bulk\n";
+
+    std::atomic<int> done{0};
+    auto task = [&done]() { done.fetch_add(1, std::memory_order_relaxed); };
+
+    for (int submitters : opts.submitters) {
+        if (submitters <= 0) {
+            continue;
+        }
+
+        double legacy = 0;
+        {
+            LegacyThreadPool pool(opts.threads);
+            legacy = measure(submitters, opts.tasks, done, [&](int count) {
+                for (int i = 0; i < count; ++i) {
+                    pool.submit(task);
+                }
+            });
+        }
+
+        utils::ThreadPool pool(opts.threads);
+
+        double submit = measure(submitters, opts.tasks, done, [&](int count) {
+            for (int i = 0; i < count; ++i) {
+                pool.submit(task);
+            }
+        });
+
+        double post = measure(submitters, opts.tasks, done, [&](int count) {
+            for (int i = 0; i < count; ++i) {
+                pool.post(task);
+            }
+        });
+
+        double bulk = measure(submitters, opts.tasks, done, [&](int count) {
+            std::vector<utils::ThreadPool::Task> batch;
+            batch.reserve(kBulkSize);
+            for (int i = 0; i < count; ++i) {
+                batch.emplace_back(task);
+                if (batch.size() == kBulkSize || i == count - 1) {
+                    pool.post_bulk(std::move(batch));
+                    batch.clear();
+                }
+            }
+        });
+
+        char line[128];
+        snprintf(line, sizeof(line), "%10d %14.1f %12.1f %12.1f %12.1f\n",
+                 submitters, legacy, submit, post, bulk);
+        std::cout << line;
+    }
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "tzzero/core/event_loop.h"
+#include "tzzero/utils/logger.h"
+#include <pthread.h>
+#include <time.h>
+#include <getopt.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 唤醒延迟基准：另一线程按固定间隔向 EventLoop 投递任务，
+// 比较阻塞模式与忙轮询模式下任务从入队到执行的 p50/p99 延迟及循环线程 CPU 占用
+
+using namespace tzzero;
+
+namespace {
+
+struct Options {
+    int tasks = 20000;
+    int gap_us = 100;
+    int budget_us = 50;
+    std::string mode = "both";
+};
+
+void print_usage(const char* program) {
+    std::cout << "TZZero Loop Wakeup Latency Benchmark\n\n"
+              << "Usage: " << program << " [OPTIONS]\n"
+              << "Options:\n"
+              << "  -n, --tasks NUM         Tasks posted per run (default: 20000)\n"
+              << "  -g, --gap US            Gap between tasks in microseconds (default: 100)\n"
+              << "  -b, --budget US         Busy-poll spin budget in microseconds (default: 50)\n"
+              << "  -m, --mode MODE         block | busy | both (default: both)\n"
+              << "  -h, --help              Show this help message\n"
+              << std::endl;
+}
+
+double thread_cpu_seconds(pthread_t thread) {
+    clockid_t clock;
+    struct timespec ts;
+    if (pthread_getcpuclockid(thread, &clock) != 0 || clock_gettime(clock, &ts) != 0) {
+        return 0.0;
+    }
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void wait_gap(int gap_us) {
+    // sleep_for 的精度不足以模拟短间隔，短间隔时忙等
+    auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(gap_us);
+    if (gap_us >= 200) {
+        std::this_thread::sleep_until(until);
+        return;
+    }
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+void run(const std::string& mode, const Options& opts) {
+    std::atomic<core::EventLoop*> loop_ptr{nullptr};
+    std::thread loop_thread([&]() {
+        core::EventLoop loop;
+        if (mode == "busy") {
+            loop.set_busy_poll(opts.budget_us);
+        }
+        loop_ptr = &loop;
+        loop.loop();
+    });
+
+    while (loop_ptr.load() == nullptr) {
+        std::this_thread::yield();
+    }
+    core::EventLoop* loop = loop_ptr.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::atomic<int> done{0};
+    uint64_t wakeups_before = loop->wakeups();
+    double cpu_start = thread_cpu_seconds(loop_thread.native_handle());
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < opts.tasks; ++i) {
+        loop->queue_in_loop([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+        wait_gap(opts.gap_us);
+    }
+    while (done.load() < opts.tasks) {
+        std::this_thread::yield();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double cpu = thread_cpu_seconds(loop_thread.native_handle()) - cpu_start;
+    const auto& latency = loop->wakeup_latency();
+
+    std::cout << mode << (mode == "busy" ? " (budget " + std::to_string(opts.budget_us) + "us)" : "") << ":\n"
+              << "  p50 wakeup:    " << latency.percentile(50) / 1000.0 << " us\n"
+              << "  p99 wakeup:    " << latency.percentile(99) / 1000.0 << " us\n"
+              << "  p99.9 wakeup:  " << latency.percentile(99.9) / 1000.0 << " us\n"
+              << "  eventfd writes:" << " " << loop->wakeups() - wakeups_before << "\n"
+              << "  loop CPU:      " << (elapsed > 0 ? cpu / elapsed * 100.0 : 0.0) << " %\n"
+              << "  loop stats:    " << loop->stats().summary() << "\n\n";
+
+    loop->quit();
+    loop_thread.join();
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+
+    struct option long_options[] = {
+        {"tasks", required_argument, 0, 'n'},
+        {"gap", required_argument, 0, 'g'},
+        {"budget", required_argument, 0, 'b'},
+        {"mode", required_argument, 0, 'm'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "n:g:b:m:h", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'n':
+                opts.tasks = std::stoi(optarg);
+                break;
+            case 'g':
+                opts.gap_us = std::stoi(optarg);
+                break;
+            case 'b':
+                opts.budget_us = std::stoi(optarg);
+                break;
+            case 'm':
+                opts.mode = optarg;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    utils::Logger::instance().set_level(utils::LogLevel::WARN);
+
+    std::vector<std::string> modes;
+    if (opts.mode == "both") {
+        modes = {"block", "busy"};
+    } else {
+        modes = {opts.mode};
+    }
+
+    std::cout << "\n=== Loop wakeup latency: " << opts.tasks << " tasks, "
+              << opts.gap_us << "us apart ===\n\n";
+
+    for (const auto& mode : modes) {
+        run(mode, opts);
+    }
+
+    return 0;
+}
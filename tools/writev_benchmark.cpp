@@ -0,0 +1,266 @@
+#include "tzzero/net/tcp_server.h"
+#include "tzzero/net/output_queue.h"
+#include "tzzero/core/event_loop.h"
+#include "tzzero/utils/buffer.h"
+#include "tzzero/utils/logger.h"
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <csignal>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 输出路径基准：客户端每个请求发一个字节，服务端回一个响应（短头部加正文）。
+// 两种场景：大响应（默认 256KB 正文，每次一个请求）和小响应流水线（默认 64 字节
+// 正文，每次 16 个请求）。两种发送方式：
+//   copy   - 每个响应把头部和正文拼成一个字符串后复制发送，与原来的输出缓冲一样
+//   slices - 一次读到的所有响应按段排进输出队列：头部接管，正文为共享数据，一次 writev
+// 统计每个响应的 write/writev 次数和复制的字节数（拼接和进入输出队列的复制都算）
+
+using namespace tzzero;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int connections = 8;
+    int duration = 2;
+    int large_size = 256 * 1024;
+    int small_size = 64;
+    int depth = 16;
+    int port = 18580;
+};
+
+void print_usage(const char* program) {
+    std::cout << "TZZero Output Path Benchmark\n\n"
+              << "Usage: " << program << " [OPTIONS]\n"
+              << "Options:\n"
+              << "  -c, --connections NUM   Client connections (default: 8)\n"
+              << "  -d, --duration SEC      Seconds per run (default: 2)\n"
+              << "  -l, --large BYTES       Large response body (default: 262144)\n"
+              << "  -s, --small BYTES       Pipelined response body (default: 64)\n"
+              << "  -p, --depth NUM         Pipelined requests per round (default: 16)\n"
+              << "  -P, --port PORT         First listen port (default: 18580)\n"
+              << "  -h, --help              Show this help message\n"
+              << std::endl;
+}
+
+std::string make_head(size_t body_size) {
+    return "HTTP/1.1 200 OK\r\ncontent-type: application/octet-stream\r\ncontent-length: " +
+           std::to_string(body_size) + "\r\n\r\n";
+}
+
+int connect_to(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+struct ClientConn {
+    int fd;
+    size_t expected = 0;   // 本轮还要收的字节
+};
+
+// 单线程客户端：每个连接发 depth 个请求，收齐响应后发下一轮，返回完成的响应数
+uint64_t run_client(int port, const Options& opts, int depth, size_t response_size) {
+    int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<ClientConn> conns;
+    for (int i = 0; i < opts.connections; ++i) {
+        int fd = connect_to(port);
+        if (fd < 0) {
+            continue;
+        }
+        conns.push_back(ClientConn{fd});
+    }
+    std::string requests(static_cast<size_t>(depth), 'r');
+    for (size_t i = 0; i < conns.size(); ++i) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        ::epoll_ctl(epfd, EPOLL_CTL_ADD, conns[i].fd, &ev);
+        conns[i].expected = response_size * depth;
+        ssize_t n = ::write(conns[i].fd, requests.data(), requests.size());
+        (void)n;
+    }
+
+    // 到时后不再发新请求，收完在途的响应再关闭，避免服务端写到已关闭的连接
+    uint64_t responses = 0;
+    auto end = Clock::now() + std::chrono::seconds(opts.duration);
+    auto give_up = end + std::chrono::seconds(2);
+    size_t outstanding = conns.size();
+    std::vector<char> sink(1 << 20);
+    epoll_event events[64];
+    while (outstanding > 0 && Clock::now() < give_up) {
+        int n = ::epoll_wait(epfd, events, 64, 100);
+        bool more = Clock::now() < end;
+        for (int i = 0; i < n; ++i) {
+            ClientConn& conn = conns[events[i].data.u64];
+            ssize_t got;
+            while ((got = ::read(conn.fd, sink.data(), sink.size())) > 0) {
+                conn.expected -= std::min(conn.expected, static_cast<size_t>(got));
+            }
+            if (conn.expected == 0) {
+                if (!more) {
+                    conn.expected = SIZE_MAX;
+                    --outstanding;
+                    continue;
+                }
+                responses += static_cast<uint64_t>(depth);
+                conn.expected = response_size * depth;
+                ssize_t w = ::write(conn.fd, requests.data(), requests.size());
+                (void)w;
+            }
+        }
+    }
+
+    for (ClientConn& conn : conns) {
+        ::close(conn.fd);
+    }
+    ::close(epfd);
+    return responses;
+}
+
+void run(const char* scenario, bool slices, int port, const Options& opts, int depth, size_t body_size) {
+    auto body = std::make_shared<const std::string>(body_size, 'b');
+    std::string head = make_head(body_size);
+    // 服务端拼接或经追加返回的复制字节，只在I/O线程中累加
+    auto app_copied = std::make_shared<uint64_t>(0);
+
+    std::atomic<core::EventLoop*> loop_ptr{nullptr};
+    std::atomic<net::TcpServer*> server_ptr{nullptr};
+    std::atomic<core::EventLoop*> io_loop_ptr{nullptr};
+    std::thread server_thread([&]() {
+        core::EventLoop loop;
+        net::TcpServer server(&loop, "127.0.0.1", static_cast<uint16_t>(port), "WritevBench");
+        server.set_thread_num(1);
+        server.set_connection_callback([&](const net::TcpConnectionPtr& conn) {
+            io_loop_ptr = conn->get_loop();
+            if (conn->connected()) {
+                conn->set_tcp_no_delay(true);
+            }
+        });
+        server.set_message_callback([slices, body, head, app_copied](const net::TcpConnectionPtr& conn,
+                                                                     utils::Buffer& buf) {
+            size_t requests = buf.readable_bytes();
+            buf.retrieve_all();
+            if (slices) {
+                net::OutputQueue pieces;
+                for (size_t i = 0; i < requests; ++i) {
+                    *app_copied += pieces.append(std::string(head));
+                    *app_copied += pieces.append_shared(body);
+                }
+                conn->send(std::move(pieces));
+            } else {
+                for (size_t i = 0; i < requests; ++i) {
+                    std::string response = head;
+                    response += *body;
+                    *app_copied += body->size();
+                    conn->send(response);
+                }
+            }
+        });
+        server.start();
+        server_ptr = &server;
+        loop_ptr = &loop;
+        loop.loop();
+    });
+    while (loop_ptr.load() == nullptr) {
+        std::this_thread::yield();
+    }
+
+    auto start = Clock::now();
+    uint64_t responses = run_client(port, opts, depth, head.size() + body_size);
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    net::TcpServer* server = server_ptr.load();
+    while (server->connection_counts().front() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    core::EventLoop* io_loop = io_loop_ptr.load();
+    uint64_t syscalls = io_loop ? io_loop->stats().output_syscalls() : 0;
+    uint64_t copied = (io_loop ? io_loop->stats().output_bytes_copied() : 0) + *app_copied;
+    loop_ptr.load()->quit();
+    server_thread.join();
+
+    double per = responses > 0 ? static_cast<double>(responses) : 1.0;
+    char line[200];
+    snprintf(line, sizeof(line), "%-10s %-7s %12.0f %10.1f %14.3f %16.1f\n",
+             scenario, slices ? "slices" : "copy", responses / seconds,
+             responses * (head.size() + body_size) / seconds / (1024 * 1024),
+             syscalls / per, copied / per);
+    std::cout << line << std::flush;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+
+    struct option long_options[] = {
+        {"connections", required_argument, 0, 'c'},
+        {"duration", required_argument, 0, 'd'},
+        {"large", required_argument, 0, 'l'},
+        {"small", required_argument, 0, 's'},
+        {"depth", required_argument, 0, 'p'},
+        {"port", required_argument, 0, 'P'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "c:d:l:s:p:P:h", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'c': opts.connections = std::stoi(optarg); break;
+            case 'd': opts.duration = std::stoi(optarg); break;
+            case 'l': opts.large_size = std::stoi(optarg); break;
+            case 's': opts.small_size = std::stoi(optarg); break;
+            case 'p': opts.depth = std::stoi(optarg); break;
+            case 'P': opts.port = std::stoi(optarg); break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    utils::Logger::instance().set_level(utils::LogLevel::WARN);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "\n=== " << opts.connections << " connections, one I/O thread; large: "
+              << opts.large_size << "-byte bodies one at a time; pipelined: " << opts.depth
+              << " x " << opts.small_size << "-byte bodies per round ===\n"
+              << "writes: write/writev calls per response; copied: bytes memcpy'd per response\n\n";
+    std::cout << "scenario   mode         resp/s       MB/s  writes/resp  copied B/resp\n";
+
+    run("large", false, opts.port, opts, 1, static_cast<size_t>(opts.large_size));
+    run("large", true, opts.port + 1, opts, 1, static_cast<size_t>(opts.large_size));
+    run("pipelined", false, opts.port + 2, opts, opts.depth, static_cast<size_t>(opts.small_size));
+    run("pipelined", true, opts.port + 3, opts, opts.depth, static_cast<size_t>(opts.small_size));
+    std::cout << std::endl;
+
+    return 0;
+}